@@ -29,11 +29,16 @@ limitations under the License.
 
 #include <sftrie/set.hpp>
 #include <trimatch/levenshtein_dfa.hpp>
+#include <trimatch/lazy_levenshtein_dfa.hpp>
+#include <trimatch/damerau_levenshtein_dfa.hpp>
+#include <trimatch/universal_levenshtein_automaton.hpp>
+#include <trimatch/bit_parallel_matcher.hpp>
 #include <trimatch/search_client.hpp>
 
 #include "matcher/edit_distance_dp.hpp"
 #include "matcher/edit_distance_bp.hpp"
 #include "matcher/online_edit_distance_dp.hpp"
+#include "matcher/recursive_dfa_construction.hpp"
 
 #include "history.hpp"
 
@@ -102,6 +107,109 @@ size_t exec_approx_dfa_trie(const set& trie,
 	return found;
 }
 
+template<std::size_t MaxEdits, typename set>
+size_t exec_approx_static_dfa_trie(const set& trie,
+	const std::vector<typename set::text_type>& queries)
+{
+	trimatch::search_client<sftrie::set<text, integer>, trimatch::LevenshteinDFA<text, integer, MaxEdits>> searcher(trie);
+	std::vector<std::tuple<text, integer, integer>> results;
+	size_t found = 0;
+	for(const auto& query: queries){
+		searcher.approx(query, MaxEdits, std::back_inserter(results));
+		found += results.size();
+		results.clear();
+	}
+	return found;
+}
+
+template<typename set>
+size_t exec_approx_dl_dfa_trie(const set& trie,
+	const std::vector<typename set::text_type>& queries, typename set::integer_type max_edits = 1)
+{
+	trimatch::search_client<sftrie::set<text, integer>, trimatch::DamerauLevenshteinDFA<text, integer>> searcher(trie);
+	std::vector<std::tuple<text, integer, integer>> results;
+	size_t found = 0;
+	for(const auto& query: queries){
+		searcher.approx(query, max_edits, std::back_inserter(results));
+		found += results.size();
+		results.clear();
+	}
+	return found;
+}
+
+template<typename set>
+size_t exec_approx_lazy_dfa_trie(const set& trie,
+	const std::vector<typename set::text_type>& queries, typename set::integer_type max_edits = 1)
+{
+	trimatch::search_client<sftrie::set<text, integer>, trimatch::LazyLevenshteinDFA<text, integer>> searcher(trie);
+	std::vector<std::tuple<text, integer, integer>> results;
+	size_t found = 0;
+	for(const auto& query: queries){
+		searcher.approx(query, max_edits, std::back_inserter(results));
+		found += results.size();
+		results.clear();
+	}
+	return found;
+}
+
+template<typename set>
+size_t exec_approx_ua_trie(const set& trie,
+	const std::vector<typename set::text_type>& queries, typename set::integer_type max_edits = 1)
+{
+	trimatch::search_client<sftrie::set<text, integer>, trimatch::UniversalLevenshteinAutomaton<text, integer>> searcher(trie);
+	std::vector<std::tuple<text, integer, integer>> results;
+	size_t found = 0;
+	for(const auto& query: queries){
+		searcher.approx(query, max_edits, std::back_inserter(results));
+		found += results.size();
+		results.clear();
+	}
+	return found;
+}
+
+template<typename set>
+size_t exec_approx_bp_trie(const set& trie,
+	const std::vector<typename set::text_type>& queries, typename set::integer_type max_edits = 1)
+{
+	trimatch::search_client<sftrie::set<text, integer>, trimatch::BitParallelMatcher<text, integer>> searcher(trie);
+	std::vector<std::tuple<text, integer, integer>> results;
+	size_t found = 0;
+	for(const auto& query: queries){
+		searcher.approx(query, max_edits, std::back_inserter(results));
+		found += results.size();
+		results.clear();
+	}
+	return found;
+}
+
+// construction only; returns the total number of DFA states
+template<typename text, typename integer>
+size_t exec_dfa_construction(const std::vector<text>& queries, integer max_edits = 1)
+{
+	size_t states = 0;
+	for(const auto& query: queries)
+		states += trimatch::LevenshteinDFA<text, integer>::compile(query, max_edits)->states.size() - 1;
+	return states;
+}
+
+template<std::size_t MaxEdits, typename text, typename integer>
+size_t exec_static_dfa_construction(const std::vector<text>& queries)
+{
+	size_t states = 0;
+	for(const auto& query: queries)
+		states += trimatch::LevenshteinDFA<text, integer, MaxEdits>::compile(query, MaxEdits)->states.size() - 1;
+	return states;
+}
+
+template<typename text, typename integer>
+size_t exec_recursive_dfa_construction(const std::vector<text>& queries, integer max_edits = 1)
+{
+	size_t states = 0;
+	for(const auto& query: queries)
+		states += RecursiveDFAConstruction<text, integer>(query, max_edits).size();
+	return states;
+}
+
 template<typename text>
 bool benchmark(const std::string& dictionary_path, const std::string& algorithm, size_t max_edits, size_t max_queries)
 {
@@ -193,6 +301,40 @@ bool benchmark(const std::string& dictionary_path, const std::string& algorithm,
 	else if(algorithm == "dfa-trie"){
 		found_approx = exec_approx_dfa_trie(index, shuffled_queries, max_edits);
 	}
+	else if(algorithm == "static-dfa-trie"){
+		if(max_edits == 1)
+			found_approx = exec_approx_static_dfa_trie<1>(index, shuffled_queries);
+		else if(max_edits == 2)
+			found_approx = exec_approx_static_dfa_trie<2>(index, shuffled_queries);
+		else
+			throw std::runtime_error("static-dfa-trie supports max_edits 1 and 2 only");
+	}
+	else if(algorithm == "lazy-dfa-trie"){
+		found_approx = exec_approx_lazy_dfa_trie(index, shuffled_queries, max_edits);
+	}
+	else if(algorithm == "dl-dfa-trie"){
+		found_approx = exec_approx_dl_dfa_trie(index, shuffled_queries, max_edits);
+	}
+	else if(algorithm == "ua-trie"){
+		found_approx = exec_approx_ua_trie(index, shuffled_queries, max_edits);
+	}
+	else if(algorithm == "bp-trie"){
+		found_approx = exec_approx_bp_trie(index, shuffled_queries, max_edits);
+	}
+	else if(algorithm == "dfa-construction"){
+		found_approx = exec_dfa_construction<text, integer>(shuffled_queries, max_edits);
+	}
+	else if(algorithm == "static-dfa-construction"){
+		if(max_edits == 1)
+			found_approx = exec_static_dfa_construction<1, text, integer>(shuffled_queries);
+		else if(max_edits == 2)
+			found_approx = exec_static_dfa_construction<2, text, integer>(shuffled_queries);
+		else
+			throw std::runtime_error("static-dfa-construction supports max_edits 1 and 2 only");
+	}
+	else if(algorithm == "recursive-dfa-construction"){
+		found_approx = exec_recursive_dfa_construction<text, integer>(shuffled_queries, max_edits);
+	}
 	else{
 		throw std::runtime_error("input file is not available: " + algorithm);
 	}
@@ -232,8 +374,10 @@ int main(int argc, char* argv[])
 {
 	if(argc < 2){
 		std::cout << "usage: " << argv[0] << " dictionary_path [algorithm=dfa-trie] [max_edits=1] [max_queries=0]" << std::endl;
-		std::cout << "  algorithm: (dp|bp|dp-trie|dfa-trie)" << std::endl;
-		std::cout << "  max_edits: allowable levenshtein distance" << std::endl;
+		std::cout << "  algorithm: (dp|bp|dp-trie|dfa-trie|lazy-dfa-trie|ua-trie|bp-trie|dl-dfa-trie|static-dfa-trie|dfa-construction|static-dfa-construction|recursive-dfa-construction)" << std::endl;
+		std::cout << "  (static-* fix max_edits at compile time and support 1 and 2)" << std::endl;
+		std::cout << "  (*-construction only builds DFAs for the queries and reports the total number of states)" << std::endl;
+		std::cout << "  max_edits: allowable levenshtein distance (damerau-levenshtein for dl-dfa-trie)" << std::endl;
 		std::cout << "  max_queries: maximum mumber of approximate search queries (set 0 to use all entries in the dictionary)" << std::endl;
 		return 0;
 	}
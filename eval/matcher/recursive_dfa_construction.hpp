@@ -0,0 +1,87 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Depth-first recursive subset construction of Levenshtein DFA,
+kept as a baseline for the construction in trimatch::LevenshteinDFA
+*/
+
+#ifndef TRIMATCH_EVAL_RECURSIVE_DFA_CONSTRUCTION
+#define TRIMATCH_EVAL_RECURSIVE_DFA_CONSTRUCTION
+
+#include <cstddef>
+#include <vector>
+#include <set>
+#include <map>
+#include <tuple>
+#include <algorithm>
+
+#include <trimatch/levenshtein_nfa.hpp>
+
+template<typename text, typename integer = std::uint32_t>
+class RecursiveDFAConstruction
+{
+public:
+	using symbol = typename text::value_type;
+	using nfa_type = trimatch::LevenshteinNFA<text, integer>;
+	using nfa_state = typename nfa_type::state;
+
+	// DFA state id, next state id, label (0 for *-transition)
+	std::vector<std::tuple<integer, integer, symbol>> transitions;
+
+	RecursiveDFAConstruction(const text& pattern, integer max_edits):
+		nfa(pattern, max_edits), nfa_transitions(nfa.transitions()), counter(0)
+	{
+		convert(nfa.start());
+		std::sort(transitions.begin(), transitions.end());
+	}
+
+	integer size() const
+	{
+		return counter;
+	}
+
+private:
+	const nfa_type nfa;
+	const std::set<symbol> nfa_transitions;
+	std::map<std::vector<nfa_state>, integer> dfa_states;
+	integer counter;
+
+	integer convert(const std::vector<nfa_state>& nfa_states)
+	{
+		const auto p = dfa_states.find(nfa_states);
+		if(p != dfa_states.end())
+			return p->second;
+
+		integer created_state = counter++;
+		dfa_states.insert(p, std::make_pair(nfa_states, created_state));
+
+		auto next0 = convert(nfa.step(nfa_states, 0));
+		transitions.emplace_back(created_state, next0, 0);
+		for(auto label: nfa_transitions){
+			auto next = convert(nfa.step(nfa_states, label));
+			if(next != next0)
+				transitions.emplace_back(created_state, next, label);
+		}
+
+		return created_state;
+	}
+};
+
+#endif
@@ -27,6 +27,7 @@ limitations under the License.
 #include <chrono>
 
 #include <trimatch/index.hpp>
+#include <trimatch/mapped_index.hpp>
 
 #include "history.hpp"
 
@@ -116,6 +117,22 @@ bool benchmark(const std::string& corpus_path, const std::string& index_path)
 	history.record("load", texts.size());
 	std::cerr << "done." << std::endl;
 
+	std::string mapped_path = index_path + ".mapped";
+	std::cerr << "saving mapped index to file...";
+	history.refresh();
+	{
+		std::ofstream ofs(mapped_path, std::ios::binary);
+		trimatch::mapped_trie<text, sftrie::empty, integer>::save(index, ofs);
+	}
+	history.record("save (mapped)", texts.size());
+	std::cerr << "done." << std::endl;
+
+	std::cerr << "mapping index file...";
+	history.refresh();
+	trimatch::mapped_index<text, sftrie::empty, integer> index3(mapped_path);
+	history.record("load (mapped)", texts.size());
+	std::cerr << "done." << std::endl;
+
 
 	std::cout << std::endl;
 	std::cout << "[input]" << std::endl;
@@ -30,6 +30,10 @@ limitations under the License.
 #include <sftrie/set.hpp>
 #include <trimatch/search_client.hpp>
 #include <trimatch/levenshtein_dfa.hpp>
+#include <trimatch/lazy_levenshtein_dfa.hpp>
+#include <trimatch/universal_levenshtein_automaton.hpp>
+#include <trimatch/bit_parallel_matcher.hpp>
+#include <trimatch/partition_search_client.hpp>
 
 #include "matcher/edit_distance_dp.hpp"
 #include "matcher/edit_distance_bp.hpp"
@@ -119,6 +123,76 @@ size_t exec_approx_dfa_trie(const set& trie,
 	return found;
 }
 
+template<typename set>
+size_t exec_approx_lazy_dfa_trie(const set& trie,
+	const std::vector<typename set::text_type>& queries, typename set::integer_type max_edits = 1)
+{
+	trimatch::search_client<sftrie::set<text, integer>, trimatch::LazyLevenshteinDFA<text, integer>> searcher(trie);
+	std::vector<std::tuple<text, integer, integer>> results;
+	size_t found = 0;
+	for(const auto& q: queries){
+		searcher.approx(q, max_edits, std::back_inserter(results));
+		for(const auto& r: results)
+			output_result(q, std::get<0>(r), std::get<2>(r));
+		found += results.size();
+		results.clear();
+	}
+	return found;
+}
+
+template<typename set>
+size_t exec_approx_ua_trie(const set& trie,
+	const std::vector<typename set::text_type>& queries, typename set::integer_type max_edits = 1)
+{
+	trimatch::search_client<sftrie::set<text, integer>, trimatch::UniversalLevenshteinAutomaton<text, integer>> searcher(trie);
+	std::vector<std::tuple<text, integer, integer>> results;
+	size_t found = 0;
+	for(const auto& q: queries){
+		searcher.approx(q, max_edits, std::back_inserter(results));
+		for(const auto& r: results)
+			output_result(q, std::get<0>(r), std::get<2>(r));
+		found += results.size();
+		results.clear();
+	}
+	return found;
+}
+
+template<typename set>
+size_t exec_approx_bp_trie(const set& trie,
+	const std::vector<typename set::text_type>& queries, typename set::integer_type max_edits = 1)
+{
+	trimatch::search_client<sftrie::set<text, integer>, trimatch::BitParallelMatcher<text, integer>> searcher(trie);
+	std::vector<std::tuple<text, integer, integer>> results;
+	size_t found = 0;
+	for(const auto& q: queries){
+		searcher.approx(q, max_edits, std::back_inserter(results));
+		for(const auto& r: results)
+			output_result(q, std::get<0>(r), std::get<2>(r));
+		found += results.size();
+		results.clear();
+	}
+	return found;
+}
+
+template<typename set>
+size_t exec_approx_partition_trie(const set& trie,
+	const std::vector<typename set::text_type>& queries, typename set::integer_type max_edits = 1)
+{
+	trimatch::reversed_keys<text, typename set::value_type, integer> reversed;
+	reversed.build(trie);
+	trimatch::partition_search_client<sftrie::set<text, integer>> searcher(trie, reversed);
+	std::vector<std::tuple<text, integer, integer>> results;
+	size_t found = 0;
+	for(const auto& q: queries){
+		searcher.approx(q, max_edits, std::back_inserter(results));
+		for(const auto& r: results)
+			output_result(q, std::get<0>(r), std::get<2>(r));
+		found += results.size();
+		results.clear();
+	}
+	return found;
+}
+
 template<typename text>
 bool validate(const std::string& dictionary_path, const std::string& algorithm, size_t max_edits)
 {
@@ -208,6 +282,18 @@ bool validate(const std::string& dictionary_path, const std::string& algorithm,
 	else if(algorithm == "dfa-trie"){
 		found_approx = exec_approx_dfa_trie(index, shuffled_queries, max_edits);
 	}
+	else if(algorithm == "lazy-dfa-trie"){
+		found_approx = exec_approx_lazy_dfa_trie(index, shuffled_queries, max_edits);
+	}
+	else if(algorithm == "ua-trie"){
+		found_approx = exec_approx_ua_trie(index, shuffled_queries, max_edits);
+	}
+	else if(algorithm == "bp-trie"){
+		found_approx = exec_approx_bp_trie(index, shuffled_queries, max_edits);
+	}
+	else if(algorithm == "partition-trie"){
+		found_approx = exec_approx_partition_trie(index, shuffled_queries, max_edits);
+	}
 	else{
 		throw std::runtime_error("unknown algorithm: " + algorithm);
 	}
@@ -247,7 +333,7 @@ int main(int argc, char* argv[])
 {
 	if(argc < 2){
 		std::cout << "usage: " << argv[0] << " dictionary_path [algorithm=dfa-trie] [max_edits=1]" << std::endl;
-		std::cout << "  algorithm: (dp|bp|dp-trie|dfa-trie)" << std::endl;
+		std::cout << "  algorithm: (dp|bp|dp-trie|dfa-trie|lazy-dfa-trie|ua-trie|bp-trie|partition-trie)" << std::endl;
 		std::cout << "  max_edits: allowable levenshtein distance" << std::endl;
 		return 0;
 	}
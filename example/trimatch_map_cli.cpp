@@ -24,6 +24,7 @@ Query options:
 - ends with '*': predictive search
 - ends with '?': apprximate search
 - ends with '&': apprximate predictive search
+- ends with '#': 10 predictive search results of the highest search counts
 */
 
 #include <iostream>
@@ -42,6 +43,13 @@ using index_type = trimatch::index<text, item, integer>;
 template<typename index_type>
 void exec(index_type& index, integer max_edits)
 {
+	// annotations must exist before the searcher is made; rebuilding them takes O(N), so they are
+	// rebuilt only after this many queries have changed search counts, and '#' may rank by older counts
+	constexpr std::size_t rebuild_interval = 100;
+	auto by_search_count = [](const item& value){ return value[1]; };
+	index.build_score_bounds(by_search_count);
+	std::size_t changed_queries = 0;
+
 	auto searcher = index.searcher();
 	auto& trie = index.raw_trie();
 	while(true){
@@ -59,7 +67,7 @@ void exec(index_type& index, integer max_edits)
 		}
 
 		auto last = query.back();
-		if(last == '<' || last == '*' || last == '?' || last == '&')
+		if(last == '<' || last == '*' || last == '?' || last == '&' || last == '#')
 			query.pop_back();
 		integer count = 0;
 		if(last == '<'){
@@ -76,6 +84,19 @@ void exec(index_type& index, integer max_edits)
 				std::cout << std::setw(4) << ++count << ": text=" << i.key() << ", id=" << value[0] << ", search count=" << ++value[1]  << std::endl;
 			}
 		}
+		else if(last == '#'){
+			// top-k predictive search by search count
+			if(changed_queries >= rebuild_interval){
+				index.build_score_bounds(by_search_count);
+				changed_queries = 0;
+			}
+			std::vector<std::tuple<text, item, double>> results;
+			searcher.predict_topk(query, 10, std::back_inserter(results));
+			for(const auto& [key, value0, score]: results){
+				auto& value = trie[key];
+				std::cout << std::setw(4) << ++count << ": text=" << key << ", id=" << value[0] << ", search count=" << ++value[1]  << std::endl;
+			}
+		}
 		else if(last == '?'){
 			// approximate search
 			for(const auto& [key, value0, edits]: searcher.approx(query, max_edits)){
@@ -113,6 +134,8 @@ void exec(index_type& index, integer max_edits)
 				std::cout << query << ": found, id=" << value[0] << ", search count=" << ++value[1]  << std::endl;
 			}
 		}
+		if(count > 0)
+			++changed_queries;
 		if(count == 0)
 			std::cout << query << ": " << "not found" << std::endl;
 	}
@@ -0,0 +1,247 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Incremental approximate predictive search for type-ahead
+
+Keeps the active nodes of Ji et al. (https://doi.org/10.1145/1526709.1526760),
+the trie nodes whose text is within max_edits of the typed query, for each
+keystroke. push(c) derives the next set from the current one, so the cost of
+a keystroke depends on the number of active nodes instead of the query length.
+*/
+
+#ifndef TRIMATCH_AUTOCOMPLETE_SESSION
+#define TRIMATCH_AUTOCOMPLETE_SESSION
+
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace trimatch{
+
+template<class trie>
+class autocomplete_session
+{
+public:
+	using text = typename trie::text_type;
+	using integer = typename trie::integer_type;
+	using symbol = typename text::value_type;
+
+	autocomplete_session(const trie& T, integer max_edits);
+
+	// append a symbol to the query
+	void push(symbol c);
+	// remove the last symbol of the query
+	void pop();
+
+	const text& query() const;
+	integer max_distance() const;
+	// number of active nodes for the current query
+	std::size_t frontier_size() const;
+
+	// at most k completions as (text, value, edits of the closest prefix to the query),
+	// in ascending order of edits
+	template<class back_insert_iterator>
+	void results(std::size_t k, back_insert_iterator bi) const;
+
+private:
+	struct active_node
+	{
+		typename trie::node_type node;
+		text key;
+		integer edits;
+	};
+	using frontier = std::vector<active_node>;
+
+	const trie& T;
+	const integer max_edits;
+
+	text current;
+	// active nodes of each prefix of the query
+	std::vector<frontier> history;
+
+	// adds a node or lowers its edits, keeping the first position of each node
+	static void relax(frontier& next, std::unordered_map<std::size_t, std::size_t>& positions,
+		typename trie::node_type node, const text& key, integer edits, std::vector<std::vector<std::size_t>>& buckets);
+	// nodes reached by inserting symbols after active nodes
+	void close(frontier& next, std::unordered_map<std::size_t, std::size_t>& positions,
+		std::vector<std::vector<std::size_t>>& buckets) const;
+
+	template<class back_insert_iterator>
+	bool collect(typename trie::node_type node, text& key, integer edits, std::unordered_set<std::size_t>& visited,
+		std::size_t k, std::size_t& found, back_insert_iterator& bi) const;
+};
+
+template<class trie>
+autocomplete_session<trie>::autocomplete_session(const trie& T, integer max_edits):
+	T(T), max_edits(max_edits)
+{
+	frontier first;
+	std::unordered_map<std::size_t, std::size_t> positions;
+	std::vector<std::vector<std::size_t>> buckets(max_edits + 1);
+	relax(first, positions, T.root(), text(), 0, buckets);
+	close(first, positions, buckets);
+	history.push_back(std::move(first));
+}
+
+template<class trie>
+void autocomplete_session<trie>::push(symbol c)
+{
+	const frontier& last = history.back();
+	frontier next;
+	std::unordered_map<std::size_t, std::size_t> positions;
+	std::vector<std::vector<std::size_t>> buckets(max_edits + 1);
+	text key;
+	for(const auto& a: last){
+		// c is deleted
+		if(a.edits < max_edits)
+			relax(next, positions, a.node, a.key, a.edits + 1, buckets);
+		// c is matched or substituted by the next symbol
+		if(a.node.leaf())
+			continue;
+		for(const auto& n: a.node.children()){
+			integer edits = a.edits + (n.label() == c ? 0 : 1);
+			if(edits <= max_edits){
+				key = a.key;
+				key.push_back(n.label());
+				relax(next, positions, n, key, edits, buckets);
+			}
+		}
+	}
+	close(next, positions, buckets);
+
+	current.push_back(c);
+	history.push_back(std::move(next));
+}
+
+template<class trie>
+void autocomplete_session<trie>::pop()
+{
+	if(current.empty())
+		return;
+	current.pop_back();
+	history.pop_back();
+}
+
+template<class trie>
+const typename autocomplete_session<trie>::text& autocomplete_session<trie>::query() const
+{
+	return current;
+}
+
+template<class trie>
+typename autocomplete_session<trie>::integer autocomplete_session<trie>::max_distance() const
+{
+	return max_edits;
+}
+
+template<class trie>
+std::size_t autocomplete_session<trie>::frontier_size() const
+{
+	return history.back().size();
+}
+
+template<class trie>
+void autocomplete_session<trie>::relax(frontier& next, std::unordered_map<std::size_t, std::size_t>& positions,
+	typename trie::node_type node, const text& key, integer edits, std::vector<std::vector<std::size_t>>& buckets)
+{
+	auto p = positions.find(node.id());
+	if(p == positions.end()){
+		positions.emplace(node.id(), next.size());
+		buckets[edits].push_back(next.size());
+		next.push_back({node, key, edits});
+	}
+	else if(edits < next[p->second].edits){
+		next[p->second].edits = edits;
+		buckets[edits].push_back(p->second);
+	}
+}
+
+// in ascending order of edits, so each node is expanded with its final edits
+template<class trie>
+void autocomplete_session<trie>::close(frontier& next, std::unordered_map<std::size_t, std::size_t>& positions,
+	std::vector<std::vector<std::size_t>>& buckets) const
+{
+	text key;
+	for(integer edits = 0; edits < max_edits; ++edits){
+		for(std::size_t b = 0; b < buckets[edits].size(); ++b){
+			std::size_t i = buckets[edits][b];
+			if(next[i].edits != edits || next[i].node.leaf())
+				continue;
+			for(const auto& n: next[i].node.children()){
+				key = next[i].key;
+				key.push_back(n.label());
+				relax(next, positions, n, key, edits + 1, buckets);
+			}
+		}
+	}
+}
+
+template<class trie>
+template<class back_insert_iterator>
+void autocomplete_session<trie>::results(std::size_t k, back_insert_iterator bi) const
+{
+	if(k == 0)
+		return;
+
+	// a subtree is visited once, from its closest active ancestor
+	std::unordered_set<std::size_t> visited;
+	std::size_t found = 0;
+	text key;
+	for(integer edits = 0; edits <= max_edits; ++edits){
+		for(const auto& a: history.back()){
+			if(a.edits != edits || visited.count(a.node.id()) > 0)
+				continue;
+			key = a.key;
+			if(!collect(a.node, key, edits, visited, k, found, bi))
+				return;
+		}
+	}
+}
+
+// returns false when k results are found
+template<class trie>
+template<class back_insert_iterator>
+bool autocomplete_session<trie>::collect(typename trie::node_type node, text& key, integer edits,
+	std::unordered_set<std::size_t>& visited, std::size_t k, std::size_t& found, back_insert_iterator& bi) const
+{
+	visited.insert(node.id());
+	if(node.match()){
+		*bi++ = {key, node.value(), edits};
+		if(++found == k)
+			return false;
+	}
+	if(node.leaf())
+		return true;
+	for(const auto& n: node.children()){
+		if(visited.count(n.id()) > 0)
+			continue;
+		key.push_back(n.label());
+		bool more = collect(n, key, edits, visited, k, found, bi);
+		key.pop_back();
+		if(!more)
+			return false;
+	}
+	return true;
+}
+
+}
+
+#endif
@@ -0,0 +1,164 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Bounded LRU cache of compiled automata shared across queries
+*/
+
+#ifndef TRIMATCH_AUTOMATON_CACHE
+#define TRIMATCH_AUTOMATON_CACHE
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <list>
+#include <map>
+#include <mutex>
+#include <concepts>
+
+namespace trimatch{
+
+// matchers whose automaton can be compiled once and shared by many traversals
+template<typename matcher, typename text, typename integer>
+concept compilable_matcher = requires(const text& pattern, integer max_edits)
+{
+	typename matcher::automaton_type;
+	{ matcher::compile(pattern, max_edits) } -> std::same_as<std::shared_ptr<const typename matcher::automaton_type>>;
+	matcher(matcher::compile(pattern, max_edits));
+};
+
+template<
+	typename text,
+	typename integer,
+	typename approximate_matcher
+>
+class automaton_cache
+{
+public:
+	using automaton_type = typename approximate_matcher::automaton_type;
+	using key_type = std::pair<text, integer>;
+
+	automaton_cache(std::size_t capacity);
+
+	// returns the compiled automaton for (pattern, max_edits), compiling it on a miss
+	std::shared_ptr<const automaton_type> get(const text& pattern, integer max_edits);
+
+	void clear();
+
+	std::size_t capacity() const;
+	std::size_t size() const;
+	std::size_t hits() const;
+	std::size_t misses() const;
+
+private:
+	using entry = std::pair<key_type, std::shared_ptr<const automaton_type>>;
+
+	const std::size_t max_size;
+
+	// most recently used first
+	std::list<entry> entries;
+	std::map<key_type, typename std::list<entry>::iterator> positions;
+
+	std::size_t hit_count;
+	std::size_t miss_count;
+
+	mutable std::mutex mutex;
+};
+
+template<typename text, typename integer, typename approximate_matcher>
+automaton_cache<text, integer, approximate_matcher>::automaton_cache(std::size_t capacity):
+	max_size(capacity), hit_count(0), miss_count(0)
+{}
+
+template<typename text, typename integer, typename approximate_matcher>
+std::shared_ptr<const typename automaton_cache<text, integer, approximate_matcher>::automaton_type>
+automaton_cache<text, integer, approximate_matcher>::get(const text& pattern, integer max_edits)
+{
+	key_type key(pattern, max_edits);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto p = positions.find(key);
+		if(p != positions.end()){
+			++hit_count;
+			entries.splice(entries.begin(), entries, p->second);
+			return p->second->second;
+		}
+		++miss_count;
+	}
+
+	// compile without holding the lock; concurrent misses for the same key may compile twice
+	auto compiled = approximate_matcher::compile(pattern, max_edits);
+	if(max_size == 0)
+		return compiled;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto p = positions.find(key);
+	if(p != positions.end()){
+		entries.splice(entries.begin(), entries, p->second);
+		return p->second->second;
+	}
+	entries.emplace_front(key, compiled);
+	positions.emplace(std::move(key), entries.begin());
+	if(entries.size() > max_size){
+		positions.erase(entries.back().first);
+		entries.pop_back();
+	}
+
+	return compiled;
+}
+
+template<typename text, typename integer, typename approximate_matcher>
+void automaton_cache<text, integer, approximate_matcher>::clear()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	entries.clear();
+	positions.clear();
+	hit_count = miss_count = 0;
+}
+
+template<typename text, typename integer, typename approximate_matcher>
+std::size_t automaton_cache<text, integer, approximate_matcher>::capacity() const
+{
+	return max_size;
+}
+
+template<typename text, typename integer, typename approximate_matcher>
+std::size_t automaton_cache<text, integer, approximate_matcher>::size() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return entries.size();
+}
+
+template<typename text, typename integer, typename approximate_matcher>
+std::size_t automaton_cache<text, integer, approximate_matcher>::hits() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return hit_count;
+}
+
+template<typename text, typename integer, typename approximate_matcher>
+std::size_t automaton_cache<text, integer, approximate_matcher>::misses() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return miss_count;
+}
+
+}
+
+#endif
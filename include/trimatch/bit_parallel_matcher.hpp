@@ -0,0 +1,258 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Online bit-parallel edit distance by Myers and Hyyro
+https://doi.org/10.1145/316542.316550
+
+Each update() computes one DP column (text symbol) over all pattern
+positions as vertical delta bit-vectors, so no automaton is constructed.
+*/
+
+#ifndef TRIMATCH_BIT_PARALLEL_MATCHER
+#define TRIMATCH_BIT_PARALLEL_MATCHER
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <bit>
+
+namespace trimatch
+{
+
+template<
+	typename text,
+	typename integer = std::uint32_t,
+	typename bitvector = std::uint64_t
+>
+class BitParallelMatcher
+{
+public:
+	using symbol = typename text::value_type;
+
+	text pattern;
+	integer max_edits;
+
+	BitParallelMatcher(const text& pattern, integer max_edits);
+
+	// start over with another pattern, reusing storage
+	void reset(const text& pattern, integer max_edits);
+
+	bool update(symbol c);
+	bool matched() const;
+	void back();
+	integer max_distance() const;
+	integer distance() const;
+	// lower bound of edits for any continuation
+	integer min_distance() const;
+
+private:
+	static constexpr integer word_size = 8 * sizeof(bitvector);
+	static constexpr bool dense = sizeof(symbol) == 1;
+
+	integer blocks;
+	bitvector last_bit;
+
+	// distinct symbols in the pattern; rank 0 is used for all other symbols
+	std::vector<symbol> alphabet;
+	std::array<integer, dense ? 256 : 0> ranks;
+	// match masks of each rank, blocks words per rank
+	std::vector<bitvector> peq;
+
+	// columns on the current path: blocks words of positive vertical deltas,
+	// followed by blocks words of negative vertical deltas; never shrinks
+	std::vector<bitvector> columns;
+	// edits for the whole pattern and minimum edits in each column
+	std::vector<std::pair<integer, integer>> scores;
+
+	void initialize();
+	integer rank(symbol c) const;
+	integer minimum(const bitvector* VP, const bitvector* VN, integer depth) const;
+};
+
+template<typename text, typename integer, typename bitvector>
+BitParallelMatcher<text, integer, bitvector>::BitParallelMatcher(const text& pattern, integer max_edits):
+	pattern(pattern), max_edits(max_edits)
+{
+	initialize();
+}
+
+template<typename text, typename integer, typename bitvector>
+void BitParallelMatcher<text, integer, bitvector>::reset(const text& pattern, integer max_edits)
+{
+	this->pattern = pattern;
+	this->max_edits = max_edits;
+	initialize();
+}
+
+template<typename text, typename integer, typename bitvector>
+void BitParallelMatcher<text, integer, bitvector>::initialize()
+{
+	blocks = std::max<integer>((static_cast<integer>(pattern.size()) + word_size - 1) / word_size, 1);
+	last_bit = pattern.empty() ? 0 : bitvector{1} << ((pattern.size() - 1) % word_size);
+
+	alphabet.assign(pattern.begin(), pattern.end());
+	std::sort(alphabet.begin(), alphabet.end());
+	alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+	if constexpr(dense){
+		ranks.fill(0);
+		for(integer i = 0; i < alphabet.size(); ++i)
+			ranks[static_cast<unsigned char>(alphabet[i])] = i + 1;
+	}
+
+	peq.assign((alphabet.size() + 1) * blocks, 0);
+	for(integer j = 0; j < pattern.size(); ++j)
+		peq[rank(pattern[j]) * blocks + j / word_size] |= bitvector{1} << (j % word_size);
+
+	// empty text: position j costs j deletions
+	columns.clear();
+	columns.reserve(2 * blocks * (pattern.size() + max_edits + 1));
+	columns.resize(blocks, ~bitvector{0});
+	columns.resize(2 * blocks, 0);
+	scores.clear();
+	scores.reserve(pattern.size() + max_edits + 1);
+	scores.emplace_back(static_cast<integer>(pattern.size()), 0);
+}
+
+template<typename text, typename integer, typename bitvector>
+inline bool BitParallelMatcher<text, integer, bitvector>::update(const symbol c)
+{
+	constexpr bitvector msb = bitvector{1} << (word_size - 1);
+
+	const integer depth = static_cast<integer>(scores.size());
+	const bitvector* Eq = &peq[rank(c) * blocks];
+	if(columns.size() < 2 * blocks * (depth + 1))
+		columns.resize(2 * blocks * (depth + 1));
+	const bitvector* VP = &columns[2 * blocks * (depth - 1)];
+	const bitvector* VN = VP + blocks;
+	bitvector* next_VP = &columns[2 * blocks * depth];
+	bitvector* next_VN = next_VP + blocks;
+
+	// horizontal delta at the top row is +1 since the empty prefix of the pattern costs depth insertions
+	int h = 1;
+	for(integer b = 0; b < blocks; ++b){
+		bitvector vp = VP[b], vn = VN[b], eq = Eq[b];
+		bitvector xv = eq | vn;
+		if(h < 0)
+			eq |= 1;
+		bitvector xh = (((eq & vp) + vp) ^ vp) | eq;
+		bitvector ph = vn | ~(xh | vp);
+		bitvector mh = vp & xh;
+
+		bitvector out = b + 1 < blocks ? msb : last_bit;
+		int next_h = (ph & out) ? 1 : ((mh & out) ? -1 : 0);
+
+		ph <<= 1;
+		mh <<= 1;
+		if(h < 0)
+			mh |= 1;
+		else if(h > 0)
+			ph |= 1;
+		next_VP[b] = mh | ~(xv | ph);
+		next_VN[b] = ph & xv;
+		h = next_h;
+	}
+
+	integer m = minimum(next_VP, next_VN, depth);
+	bool updatable = m <= max_edits;
+	if(updatable)
+		scores.emplace_back(pattern.empty() ? depth : scores.back().first + h, m);
+
+	return updatable;
+}
+
+template<typename text, typename integer, typename bitvector>
+inline bool BitParallelMatcher<text, integer, bitvector>::matched() const
+{
+	return scores.back().first <= max_edits;
+}
+
+template<typename text, typename integer, typename bitvector>
+inline void BitParallelMatcher<text, integer, bitvector>::back()
+{
+	if(scores.size() > 1)
+		scores.pop_back();
+}
+
+template<typename text, typename integer, typename bitvector>
+inline integer BitParallelMatcher<text, integer, bitvector>::max_distance() const
+{
+	return max_edits;
+}
+
+template<typename text, typename integer, typename bitvector>
+inline integer BitParallelMatcher<text, integer, bitvector>::distance() const
+{
+	return matched() ? scores.back().first : scores.back().second;
+}
+
+template<typename text, typename integer, typename bitvector>
+inline integer BitParallelMatcher<text, integer, bitvector>::min_distance() const
+{
+	return scores.back().second;
+}
+
+template<typename text, typename integer, typename bitvector>
+inline integer BitParallelMatcher<text, integer, bitvector>::rank(const symbol c) const
+{
+	if constexpr(dense){
+		return ranks[static_cast<unsigned char>(c)];
+	}
+	else{
+		auto p = std::lower_bound(alphabet.begin(), alphabet.end(), c);
+		return p != alphabet.end() && *p == c ? static_cast<integer>(p - alphabet.begin()) + 1 : 0;
+	}
+}
+
+// minimum edits of the column at depth; only positions within max_edits of the depth can be small enough
+template<typename text, typename integer, typename bitvector>
+inline integer BitParallelMatcher<text, integer, bitvector>::minimum(
+	const bitvector* VP, const bitvector* VN, integer depth) const
+{
+	const integer m = static_cast<integer>(pattern.size());
+	const integer first = depth > max_edits ? depth - max_edits : 0;
+	if(first > m)
+		return max_edits + 1;
+	const integer last = std::min(depth + max_edits, m);
+
+	// bit j - 1 holds the vertical delta between positions j - 1 and j
+	int d = static_cast<int>(depth);
+	for(integer b = 0; b < first / word_size; ++b)
+		d += std::popcount(VP[b]) - std::popcount(VN[b]);
+	if(first % word_size > 0){
+		bitvector mask = (bitvector{1} << (first % word_size)) - 1;
+		d += std::popcount(static_cast<bitvector>(VP[first / word_size] & mask)) -
+			std::popcount(static_cast<bitvector>(VN[first / word_size] & mask));
+	}
+
+	int result = d;
+	for(integer j = first; j < last; ++j){
+		d += static_cast<int>((VP[j / word_size] >> (j % word_size)) & 1) - static_cast<int>((VN[j / word_size] >> (j % word_size)) & 1);
+		result = std::min(result, d);
+	}
+
+	return static_cast<integer>(result);
+}
+
+}
+
+#endif
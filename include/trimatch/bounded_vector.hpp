@@ -0,0 +1,82 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Vector with a capacity fixed at compile time, stored inline
+*/
+
+#ifndef TRIMATCH_BOUNDED_VECTOR
+#define TRIMATCH_BOUNDED_VECTOR
+
+#include <cstddef>
+#include <cassert>
+#include <array>
+#include <utility>
+
+namespace trimatch
+{
+
+template<typename T, std::size_t capacity>
+class bounded_vector
+{
+public:
+	using value_type = T;
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	bounded_vector(): n(0) {}
+
+	std::size_t size() const { return n; }
+	bool empty() const { return n == 0; }
+	void clear() { n = 0; }
+
+	template<typename... args>
+	void emplace_back(args&&... values)
+	{
+		assert(n < capacity);
+		data[n++] = T(std::forward<args>(values)...);
+	}
+
+	T& operator[](std::size_t i) { return data[i]; }
+	const T& operator[](std::size_t i) const { return data[i]; }
+	const T& front() const { return data[0]; }
+	const T& back() const { return data[n - 1]; }
+
+	iterator begin() { return data.data(); }
+	iterator end() { return data.data() + n; }
+	const_iterator begin() const { return data.data(); }
+	const_iterator end() const { return data.data() + n; }
+
+	template<class iterator_type>
+	void assign(iterator_type first, iterator_type last)
+	{
+		for(n = 0; first != last; ++first){
+			assert(n < capacity);
+			data[n++] = *first;
+		}
+	}
+
+private:
+	std::array<T, capacity> data;
+	std::size_t n;
+};
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+DFA version of restricted Damerau-Levenshtein automata,
+where an adjacent transposition counts as a single edit
+*/
+
+#ifndef TRIMATCH_DAMERAU_LEVENSHTEIN_DFA
+#define TRIMATCH_DAMERAU_LEVENSHTEIN_DFA
+
+#include <cstddef>
+#include <memory>
+
+#include "damerau_levenshtein_nfa.hpp"
+#include "levenshtein_dfa.hpp"
+
+namespace trimatch
+{
+
+template<
+	typename text,
+	typename integer = std::uint32_t
+>
+class DamerauLevenshteinDFA: public LevenshteinDFA<text, integer>
+{
+public:
+	using automaton = typename LevenshteinDFA<text, integer>::automaton;
+
+	static std::shared_ptr<const automaton> compile(const text& pattern, integer max_edits)
+	{
+		return std::make_shared<const automaton>(DamerauLevenshteinNFA<text, integer>(pattern, max_edits));
+	}
+
+	DamerauLevenshteinDFA(const DamerauLevenshteinNFA<text, integer>& nfa):
+		LevenshteinDFA<text, integer>(nfa)
+	{}
+
+	DamerauLevenshteinDFA(const text& pattern, integer max_edits):
+		DamerauLevenshteinDFA(DamerauLevenshteinNFA<text, integer>(pattern, max_edits))
+	{}
+
+	DamerauLevenshteinDFA(std::shared_ptr<const automaton> compiled):
+		LevenshteinDFA<text, integer>(std::move(compiled))
+	{}
+
+	using LevenshteinDFA<text, integer>::reset;
+
+	void reset(const text& pattern, integer max_edits)
+	{
+		LevenshteinDFA<text, integer>::reset(DamerauLevenshteinNFA<text, integer>(pattern, max_edits));
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Levenshtein automata extended with adjacent transpositions
+(restricted Damerau-Levenshtein distance, a.k.a. optimal string alignment)
+*/
+
+#ifndef TRIMATCH_DAMERAU_LEVENSHTEIN_NFA
+#define TRIMATCH_DAMERAU_LEVENSHTEIN_NFA
+
+#include <cstddef>
+#include <vector>
+#include <set>
+#include <tuple>
+#include <algorithm>
+
+namespace trimatch
+{
+
+template<
+	typename text,
+	typename integer = std::uint32_t
+>
+class DamerauLevenshteinNFA
+{
+public:
+	using symbol = typename text::value_type;
+	// position, edits, transposing
+	// a transposing state at position i has read pattern[i + 1] and waits for pattern[i]
+	using state = std::tuple<integer, integer, bool>;
+
+	const text pattern;
+	const integer max_edits;
+
+	DamerauLevenshteinNFA(const text& pattern, integer max_edits):
+		pattern(pattern), max_edits(max_edits)
+	{}
+
+	std::vector<state> start() const
+	{
+		std::vector<state> states;
+		for(integer i = 0; i <= max_edits && i <= pattern.size(); ++i)
+			states.emplace_back(i, i, false);
+		return states;
+	}
+
+	std::vector<state> step(const std::vector<state>& states, symbol c) const
+	{
+		const integer m = static_cast<integer>(pattern.size()), none = max_edits + 1;
+		std::vector<integer> edits(m + 1, none), transposing(m + 1, none);
+		for(const auto& [i, e, t]: states){
+			if(t){
+				// transposition completed
+				if(pattern[i] == c)
+					edits[i + 2] = std::min(edits[i + 2], e);
+				continue;
+			}
+			// insertion
+			edits[i] = std::min(edits[i], e + 1);
+			if(i < m){
+				// match or substitution
+				edits[i + 1] = std::min(edits[i + 1], e + (pattern[i] == c ? 0 : 1));
+				// first half of transposition
+				if(i + 1 < m && pattern[i + 1] == c && pattern[i] != c)
+					transposing[i] = std::min(transposing[i], e + 1);
+			}
+		}
+
+		std::vector<state> new_states;
+		for(integer i = 0; i <= m; ++i){
+			// deletion
+			if(i > 0)
+				edits[i] = std::min(edits[i], edits[i - 1] + 1);
+			if(edits[i] <= max_edits)
+				new_states.emplace_back(i, edits[i], false);
+			if(transposing[i] <= max_edits)
+				new_states.emplace_back(i, transposing[i], true);
+		}
+
+		return new_states;
+	}
+
+	bool is_match(const std::vector<state>& states) const
+	{
+		return !states.empty() && std::get<0>(states.back()) == pattern.size();
+	}
+
+	bool can_match(const std::vector<state>& states) const
+	{
+		return !states.empty();
+	}
+
+	std::set<symbol> transitions() const
+	{
+		return std::set<symbol>(pattern.begin(), pattern.end());
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Node of a key or a prefix in a trie
+*/
+
+#ifndef TRIMATCH_FIND_NODE
+#define TRIMATCH_FIND_NODE
+
+#include <optional>
+
+namespace trimatch{
+
+// node reached from the root by the symbols of query, if any; T.find() searches the sorted children
+// of each node and returns a node not labeled with the last symbol, such as the root, if there is none
+template<class trie, class text>
+std::optional<typename trie::node_type> find_node(const trie& T, const text& query)
+{
+	auto node = T.find(query);
+	if(!query.empty() && (node.id() == 0 || node.label() != query.back()))
+		return std::nullopt;
+	return node;
+}
+
+}
+
+#endif
@@ -25,8 +25,17 @@ Controller for index and searcher
 #define TRIMATCH_INDEX
 
 #include <cstddef>
+#include <cstdint>
+#include <array>
 #include <iterator>
 #include <fstream>
+#include <filesystem>
+#include <functional>
+#include <stdexcept>
+#include <cstdlib>
+
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <sftrie/random_access_container.hpp>
 #include <sftrie/util.hpp>
@@ -34,6 +43,11 @@ Controller for index and searcher
 #include "trie_selector.hpp"
 #include "levenshtein_dfa.hpp"
 #include "search_client.hpp"
+#include "length_bounds.hpp"
+#include "score_bounds.hpp"
+#include "subtree_counts.hpp"
+#include "reversed_keys.hpp"
+#include "mapped_trie.hpp"
 #include "readable.hpp"
 
 namespace trimatch{
@@ -76,6 +90,34 @@ public:
 	template<typename output_stream>
 	void save(output_stream& os) const;
 	void save(std::string path) const;
+	// layout used in place by mapped_index; only the trie is written, without bounds, counts or reversed keys
+	template<typename output_stream>
+	void save_mapped(output_stream& os) const;
+	// writes a new temporary file next to path and renames it to path, so that indexes mapping
+	// an older file keep it and concurrent writers do not share the temporary file
+	void save_mapped(std::string path) const;
+
+	// lengths of the shortest and the longest keys in each subtree, which let approximate search
+	// skip subtrees by length alone; kept up to date by build() and included in save() once built
+	void build_length_bounds();
+	bool has_length_bounds() const;
+
+	// score of each key given by score(value) and the maximum score in each subtree, which let
+	// predict_topk() skip subtrees of low scores; rebuilt by build() and included in save() once built;
+	// call this again after changing values through raw_trie()
+	template<class projection>
+	void build_score_bounds(projection score);
+	bool has_score_bounds() const;
+
+	// number of keys in each subtree, which lets predict_count() answer without traversal;
+	// kept up to date by build() and included in save() once built
+	void build_subtree_counts();
+	bool has_subtree_counts() const;
+
+	// trie of the reversed keys, which enables suffix(), approx_suffix() and, with subtree counts, approx_bidirectional();
+	// kept up to date by build() and included in save() once built
+	void build_reversed_keys();
+	bool has_reversed_keys() const;
 
 	searcher_type searcher() const;
 
@@ -83,6 +125,26 @@ public:
 
 private:
 	trie T;
+	length_bounds<integer> bounds;
+	score_bounds<> scores;
+	subtree_counts<integer> counts;
+	reversed_keys<text, value_type, integer> reversed;
+	// not saved; indexes loaded with score bounds drop them on build()
+	std::function<double(const value_type&)> score_projection;
+
+	void rebuild_bounds();
+
+	// written after the trie and followed by flags; indexes saved by earlier versions end with the trie
+	static constexpr std::array<char, 8> components_magic = {'T', 'R', 'I', 'M', 'C', 'O', 'M', 'P'};
+	static constexpr std::uint8_t components_version = 1;
+	// false if the stream ends or continues with other data; the stream is then put back after the trie if possible
+	template<readable input_stream>
+	static bool read_components_header(input_stream& is);
+
+	static constexpr std::uint8_t with_length_bounds = 1;
+	static constexpr std::uint8_t with_score_bounds = 2;
+	static constexpr std::uint8_t with_subtree_counts = 4;
+	static constexpr std::uint8_t with_reversed_keys = 8;
 };
 
 template<class text, class item, class integer, class trie, class approximate_matcher>
@@ -109,20 +171,26 @@ index<text, item, integer, trie, approximate_matcher>::index(
 template<class text, class item, class integer, class trie, class approximate_matcher>
 template<readable input_stream>
 index<text, item, integer, trie, approximate_matcher>::index(input_stream& is):
-	T(is)
-{}
+	T()
+{
+	load(is);
+}
 
 template<class text, class item, class integer, class trie, class approximate_matcher>
 index<text, item, integer, trie, approximate_matcher>::index(std::string path):
-	T(path)
-{}
+	T()
+{
+	load(path);
+}
 
 template<class text, class item, class integer, class trie, class approximate_matcher>
 template<std::random_access_iterator iterator>
 integer index<text, item, integer, trie, approximate_matcher>::build(
 	iterator begin, iterator end, bool two_pass)
 {
-	return T.construct(begin, end, two_pass);
+	integer n = T.construct(begin, end, two_pass);
+	rebuild_bounds();
+	return n;
 }
 
 template<class text, class item, class integer, class trie, class approximate_matcher>
@@ -130,20 +198,73 @@ template<sftrie::random_access_container container>
 integer index<text, item, integer, trie, approximate_matcher>::build(
 	const container& texts, bool two_pass)
 {
-	return T.construct(texts, two_pass);
+	integer n = T.construct(texts, two_pass);
+	rebuild_bounds();
+	return n;
 }
 
 template<class text, class item, class integer, class trie, class approximate_matcher>
 template<readable input_stream>
 integer index<text, item, integer, trie, approximate_matcher>::load(input_stream& is)
 {
-	return T.load(is);
+	integer n = T.load(is);
+
+	std::uint8_t flags = 0;
+	if(read_components_header(is))
+		is.read(reinterpret_cast<char*>(&flags), sizeof(flags));
+	if(flags & with_length_bounds)
+		bounds.load(is);
+	else
+		bounds.clear();
+	if(flags & with_score_bounds)
+		scores.load(is);
+	else
+		scores.clear();
+	if(flags & with_subtree_counts)
+		counts.load(is);
+	else
+		counts.clear();
+	if(flags & with_reversed_keys)
+		reversed.load(is);
+	else
+		reversed.clear();
+	score_projection = nullptr;
+
+	return n;
+}
+
+template<class text, class item, class integer, class trie, class approximate_matcher>
+template<readable input_stream>
+bool index<text, item, integer, trie, approximate_matcher>::read_components_header(input_stream& is)
+{
+	std::array<char, 8> marker = {};
+	std::uint8_t version = 0;
+	if constexpr(requires{ is.good(); is.clear(); is.seekg(is.tellg()); }){
+		auto start = is.tellg();
+		is.read(marker.data(), marker.size());
+		is.read(reinterpret_cast<char*>(&version), sizeof(version));
+		if(!is.good() || marker != components_magic){
+			is.clear();
+			is.seekg(start);
+			return false;
+		}
+	}
+	else{
+		is.read(marker.data(), marker.size());
+		is.read(reinterpret_cast<char*>(&version), sizeof(version));
+		if(marker != components_magic)
+			return false;
+	}
+	if(version != components_version)
+		throw std::runtime_error("unsupported index version");
+	return true;
 }
 
 template<class text, class item, class integer, class trie, class approximate_matcher>
 integer index<text, item, integer, trie, approximate_matcher>::load(std::string path)
 {
-	return T.load(path);
+	std::ifstream ifs(path, std::ios::binary);
+	return load(ifs);
 }
 
 template<class text, class item, class integer, class trie, class approximate_matcher>
@@ -151,19 +272,129 @@ template<class output_stream>
 void index<text, item, integer, trie, approximate_matcher>::save(output_stream& os) const
 {
 	T.save(os);
+
+	os.write(components_magic.data(), components_magic.size());
+	os.write(reinterpret_cast<const char*>(&components_version), sizeof(components_version));
+	std::uint8_t flags = (bounds.empty() ? 0 : with_length_bounds) | (scores.empty() ? 0 : with_score_bounds) |
+		(counts.empty() ? 0 : with_subtree_counts) | (reversed.empty() ? 0 : with_reversed_keys);
+	os.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+	if(!bounds.empty())
+		bounds.save(os);
+	if(!scores.empty())
+		scores.save(os);
+	if(!counts.empty())
+		counts.save(os);
+	if(!reversed.empty())
+		reversed.save(os);
 }
 
 template<class text, class item, class integer, class trie, class approximate_matcher>
 void index<text, item, integer, trie, approximate_matcher>::save(std::string path) const
 {
-	T.save(path);
+	std::ofstream ofs(path, std::ios::binary);
+	save(ofs);
+}
+
+template<class text, class item, class integer, class trie, class approximate_matcher>
+template<class output_stream>
+void index<text, item, integer, trie, approximate_matcher>::save_mapped(output_stream& os) const
+{
+	mapped_trie<text, item, integer>::save(T, os);
+}
+
+template<class text, class item, class integer, class trie, class approximate_matcher>
+void index<text, item, integer, trie, approximate_matcher>::save_mapped(std::string path) const
+{
+	std::string temporary = path + ".XXXXXX";
+	int fd = mkstemp(temporary.data());
+	if(fd < 0)
+		throw std::runtime_error("failed to create a temporary file for " + path);
+	// mkstemp() creates files readable only by the owner
+	fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	close(fd);
+	{
+		std::ofstream ofs(temporary, std::ios::binary | std::ios::trunc);
+		save_mapped(ofs);
+		ofs.close();
+		if(!ofs){
+			std::filesystem::remove(temporary);
+			throw std::runtime_error("failed to write " + temporary);
+		}
+	}
+	std::filesystem::rename(temporary, path);
+}
+
+template<class text, class item, class integer, class trie, class approximate_matcher>
+void index<text, item, integer, trie, approximate_matcher>::build_length_bounds()
+{
+	bounds.build(T);
+}
+
+template<class text, class item, class integer, class trie, class approximate_matcher>
+bool index<text, item, integer, trie, approximate_matcher>::has_length_bounds() const
+{
+	return !bounds.empty();
+}
+
+template<class text, class item, class integer, class trie, class approximate_matcher>
+template<class projection>
+void index<text, item, integer, trie, approximate_matcher>::build_score_bounds(projection score)
+{
+	score_projection = score;
+	scores.build(T, score_projection);
+}
+
+template<class text, class item, class integer, class trie, class approximate_matcher>
+bool index<text, item, integer, trie, approximate_matcher>::has_score_bounds() const
+{
+	return !scores.empty();
+}
+
+template<class text, class item, class integer, class trie, class approximate_matcher>
+void index<text, item, integer, trie, approximate_matcher>::build_subtree_counts()
+{
+	counts.build(T);
+}
+
+template<class text, class item, class integer, class trie, class approximate_matcher>
+bool index<text, item, integer, trie, approximate_matcher>::has_subtree_counts() const
+{
+	return !counts.empty();
+}
+
+template<class text, class item, class integer, class trie, class approximate_matcher>
+void index<text, item, integer, trie, approximate_matcher>::build_reversed_keys()
+{
+	reversed.build(T);
+}
+
+template<class text, class item, class integer, class trie, class approximate_matcher>
+bool index<text, item, integer, trie, approximate_matcher>::has_reversed_keys() const
+{
+	return !reversed.empty();
+}
+
+template<class text, class item, class integer, class trie, class approximate_matcher>
+void index<text, item, integer, trie, approximate_matcher>::rebuild_bounds()
+{
+	if(!bounds.empty())
+		bounds.build(T);
+	if(!counts.empty())
+		counts.build(T);
+	if(!reversed.empty())
+		reversed.build(T);
+	if(score_projection)
+		scores.build(T, score_projection);
+	else
+		scores.clear();
 }
 
 template<class text, class item, class integer, class trie, class approximate_matcher>
 search_client<trie, approximate_matcher>
 index<text, item, integer, trie, approximate_matcher>::searcher() const
 {
-	return search_client<trie, approximate_matcher>(T);
+	return search_client<trie, approximate_matcher>(T, bounds.empty() ? nullptr : &bounds,
+		scores.empty() ? nullptr : &scores, counts.empty() ? nullptr : &counts, reversed.empty() ? nullptr : &reversed);
 }
 
 template<class text, class item, class integer, class trie, class approximate_matcher>
@@ -0,0 +1,233 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Lazy version of LevenshteinDFA: states and transitions are materialized when
+update() reaches them for the first time. At most max_states states are kept;
+after that, new states are only kept while they are on the current path.
+*/
+
+#ifndef TRIMATCH_LAZY_LEVENSHTEIN_DFA
+#define TRIMATCH_LAZY_LEVENSHTEIN_DFA
+
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <limits>
+#include <algorithm>
+
+#include "levenshtein_nfa.hpp"
+
+namespace trimatch
+{
+
+template<
+	typename text,
+	typename integer = std::uint32_t
+>
+class LazyLevenshteinDFA
+{
+public:
+	using symbol = typename text::value_type;
+
+	struct state;
+
+	static constexpr integer default_max_states = 16384;
+
+	const text pattern;
+	const integer max_edits;
+	const integer max_states;
+
+	LazyLevenshteinDFA(const LevenshteinNFA<text>& nfa, integer max_states = default_max_states);
+	LazyLevenshteinDFA(const text& pattern, integer max_edits, integer max_states = default_max_states);
+
+	bool update(symbol c);
+	bool matched() const;
+	void back();
+	integer max_distance() const;
+	integer distance() const;
+	// lower bound of edits for any continuation
+	integer min_distance() const;
+
+	// number of memoized states
+	integer size() const;
+
+private:
+	using nfa_state = typename LevenshteinNFA<text>::state;
+
+	static constexpr integer undefined = std::numeric_limits<integer>::max();
+
+	const LevenshteinNFA<text> nfa;
+
+	// distinct symbols in the pattern; rank 0 is used for all other symbols
+	std::vector<symbol> alphabet;
+
+	// memoized states come first, followed by states only on the current path
+	std::vector<state> states;
+	integer memoized;
+	std::vector<integer> transitions;
+	std::map<std::vector<nfa_state>, integer> dfa_states;
+
+	std::vector<integer> current_states;
+
+	integer rank(symbol c) const;
+	integer materialize(integer from, symbol c);
+	integer add_state(std::vector<nfa_state>&& nfa_states);
+};
+
+template<typename text, typename integer>
+struct LazyLevenshteinDFA<text, integer>::state
+{
+	std::vector<nfa_state> nfa_states;
+	bool match;
+	integer edits;
+	integer min_edits;
+};
+
+template<typename text, typename integer>
+LazyLevenshteinDFA<text, integer>::LazyLevenshteinDFA(const LevenshteinNFA<text>& nfa, integer max_states):
+	pattern(nfa.pattern), max_edits(nfa.max_edits), max_states(std::max(max_states, integer{1})),
+	nfa(nfa), alphabet(pattern.begin(), pattern.end()), memoized(0)
+{
+	std::sort(alphabet.begin(), alphabet.end());
+	alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+
+	// initial state
+	current_states.push_back(add_state(nfa.start()));
+}
+
+template<typename text, typename integer>
+LazyLevenshteinDFA<text, integer>::LazyLevenshteinDFA(const text& pattern, integer max_edits, integer max_states):
+	LazyLevenshteinDFA(LevenshteinNFA<text>(pattern, max_edits), max_states)
+{}
+
+template<typename text, typename integer>
+inline bool LazyLevenshteinDFA<text, integer>::update(const symbol c)
+{
+	integer current = current_states.back(), next;
+	if(current < memoized){
+		auto t = current * static_cast<integer>(alphabet.size() + 1) + rank(c);
+		if(transitions[t] == undefined){
+			next = materialize(current, c);
+			if(next < memoized)
+				transitions[t] = next;
+		}
+		else{
+			next = transitions[t];
+		}
+	}
+	else{
+		next = materialize(current, c);
+	}
+
+	bool updatable = states[next].edits <= max_edits;
+	if(updatable)
+		current_states.push_back(next);
+	else if(next >= memoized)
+		states.pop_back();
+
+	return updatable;
+}
+
+template<typename text, typename integer>
+inline bool LazyLevenshteinDFA<text, integer>::matched() const
+{
+	return states[current_states.back()].match;
+}
+
+template<typename text, typename integer>
+inline void LazyLevenshteinDFA<text, integer>::back()
+{
+	if(current_states.size() > 1){
+		if(current_states.back() >= memoized)
+			states.pop_back();
+		current_states.pop_back();
+	}
+}
+
+template<typename text, typename integer>
+inline integer LazyLevenshteinDFA<text, integer>::max_distance() const
+{
+	return max_edits;
+}
+
+template<typename text, typename integer>
+inline integer LazyLevenshteinDFA<text, integer>::distance() const
+{
+	return states[current_states.back()].edits;
+}
+
+template<typename text, typename integer>
+inline integer LazyLevenshteinDFA<text, integer>::min_distance() const
+{
+	return states[current_states.back()].min_edits;
+}
+
+template<typename text, typename integer>
+inline integer LazyLevenshteinDFA<text, integer>::size() const
+{
+	return memoized;
+}
+
+template<typename text, typename integer>
+inline integer LazyLevenshteinDFA<text, integer>::rank(const symbol c) const
+{
+	auto p = std::lower_bound(alphabet.begin(), alphabet.end(), c);
+	return p != alphabet.end() && *p == c ? static_cast<integer>(p - alphabet.begin()) + 1 : 0;
+}
+
+template<typename text, typename integer>
+integer LazyLevenshteinDFA<text, integer>::materialize(integer from, symbol c)
+{
+	// symbols not in the pattern share one transition, so stepping with c itself is safe
+	auto nfa_states = nfa.step(states[from].nfa_states, c);
+	const auto p = dfa_states.find(nfa_states);
+	if(p != dfa_states.end())
+		return p->second;
+	return add_state(std::move(nfa_states));
+}
+
+template<typename text, typename integer>
+integer LazyLevenshteinDFA<text, integer>::add_state(std::vector<nfa_state>&& nfa_states)
+{
+	bool match = nfa.is_match(nfa_states);
+	integer edits = max_edits + 1, min_edits = max_edits + 1;
+	for(const auto& n: nfa_states){
+		min_edits = std::min(min_edits, static_cast<integer>(n.second));
+		if(match && n.first == static_cast<integer>(pattern.size()))
+			edits = std::min(edits, static_cast<integer>(n.second));
+	}
+	if(!match)
+		edits = min_edits;
+
+	integer id = static_cast<integer>(states.size());
+	if(memoized < max_states){
+		// memoized states never coexist with temporary ones, so ids stay contiguous
+		dfa_states.emplace(nfa_states, id);
+		transitions.resize(transitions.size() + alphabet.size() + 1, undefined);
+		++memoized;
+	}
+	states.push_back({std::move(nfa_states), match, edits, min_edits});
+
+	return id;
+}
+
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Minimum and maximum lengths of keys in each subtree of a trie
+*/
+
+#ifndef TRIMATCH_LENGTH_BOUNDS
+#define TRIMATCH_LENGTH_BOUNDS
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+#include "node_annotation.hpp"
+
+namespace trimatch{
+
+template<typename integer = std::uint32_t>
+class length_bounds: public node_annotation<integer, 2>
+{
+public:
+	template<class trie>
+	void build(const trie& T);
+
+	// lengths of the shortest and the longest keys below node id; min > max if there is no key
+	integer min(integer id) const;
+	integer max(integer id) const;
+
+private:
+	static constexpr std::size_t lower = 0;
+	static constexpr std::size_t upper = 1;
+
+	template<class node_type>
+	void build(node_type node, integer depth);
+};
+
+template<typename integer>
+template<class trie>
+void length_bounds<integer>::build(const trie& T)
+{
+	this->data[lower].assign(T.node_size(), std::numeric_limits<integer>::max());
+	this->data[upper].assign(T.node_size(), 0);
+	build(T.root(), 0);
+}
+
+template<typename integer>
+template<class node_type>
+void length_bounds<integer>::build(node_type node, integer depth)
+{
+	auto& shortest = this->data[lower];
+	auto& longest = this->data[upper];
+	integer id = node.id();
+	if(node.match()){
+		shortest[id] = depth;
+		longest[id] = depth;
+	}
+	if(node.leaf())
+		return;
+	for(const auto& n: node.children()){
+		build(n, depth + 1);
+		shortest[id] = std::min(shortest[id], shortest[n.id()]);
+		longest[id] = std::max(longest[id], longest[n.id()]);
+	}
+}
+
+template<typename integer>
+inline integer length_bounds<integer>::min(integer id) const
+{
+	return this->data[lower][id];
+}
+
+template<typename integer>
+inline integer length_bounds<integer>::max(integer id) const
+{
+	return this->data[upper][id];
+}
+
+}
+
+#endif
@@ -27,17 +27,28 @@ https://julesjacobs.com/2015/06/17/disqus-levenshtein-simple-and-fast.html
 
 #include <cstddef>
 #include <vector>
-#include <set>
-#include <map>
-
+#include <array>
+#include <tuple>
+#include <algorithm>
+#include <utility>
+#include <memory>
+#include <type_traits>
+#include <stdexcept>
+
+#include "bounded_vector.hpp"
 #include "levenshtein_nfa.hpp"
 
 namespace trimatch
 {
 
+// MaxEdits of LevenshteinDFA given at run time
+inline constexpr std::size_t dynamic_max_edits = static_cast<std::size_t>(-1);
+
+// if MaxEdits is given, max_edits must be equal to it
 template<
 	typename text,
-	typename integer = std::uint32_t
+	typename integer = std::uint32_t,
+	std::size_t MaxEdits = dynamic_max_edits
 >
 class LevenshteinDFA
 {
@@ -46,47 +57,65 @@ public:
 
 	struct state;
 	struct transition;
+	// immutable part, which can be shared by multiple traversals
+	struct automaton;
+
+	using automaton_type = automaton;
 
-	const text pattern;
-	const integer max_edits;
+	text pattern;
+	integer max_edits;
 
 	static constexpr const symbol nullchar();
 
-	LevenshteinDFA(const LevenshteinNFA<text>& nfa);
+	static std::shared_ptr<const automaton> compile(const text& pattern, integer max_edits);
+
+	template<class nfa_type = LevenshteinNFA<text>>
+	LevenshteinDFA(const nfa_type& nfa);
 	LevenshteinDFA(const text& pattern, integer max_edits);
+	LevenshteinDFA(std::shared_ptr<const automaton> compiled);
+
+	// start over with another pattern; storage of the automaton built by this matcher is reused
+	template<class nfa_type = LevenshteinNFA<text>>
+	void reset(const nfa_type& nfa);
+	void reset(const text& pattern, integer max_edits);
+	void reset(std::shared_ptr<const automaton> compiled);
 
 	bool update(symbol c);
 	bool matched() const;
 	void back();
 	integer max_distance() const;
 	integer distance() const;
+	// lower bound of edits for any continuation
+	integer min_distance() const;
 
 private:
-	using nfa_state = typename LevenshteinNFA<text>::state;
+	// byte symbols use dense transition rows instead of searching transitions
+	static constexpr bool dense = sizeof(symbol) == 1;
+	static constexpr bool fixed = MaxEdits != dynamic_max_edits;
 
-	std::vector<state> states;
-	std::vector<transition> transitions;
+	static void check(integer max_edits);
 
-	std::vector<integer> current_states;
+	std::shared_ptr<const automaton> dfa;
+	// automaton built by this matcher, which is only shared with its copies
+	std::shared_ptr<automaton> own;
 
-	integer convert(const LevenshteinNFA<text>& nfa,
-		const std::vector<nfa_state>& nfa_states, const std::set<symbol>& nfa_transitions,
-		std::map<std::vector<nfa_state>, integer>& dfa_states, integer& counter);
+	std::vector<integer> current_states;
 };
 
-template<typename text, typename integer>
-struct LevenshteinDFA<text, integer>::state
+template<typename text, typename integer, std::size_t MaxEdits>
+struct LevenshteinDFA<text, integer, MaxEdits>::state
 {
 	integer start;
 	bool match;
 	integer edits;
+	integer min_edits;
 
 	state();
-	state(integer start, bool match, integer edits);
+	state(integer start, bool match, integer edits, integer min_edits);
 };
 
-template<typename text, typename integer>
-struct LevenshteinDFA<text, integer>::transition
+template<typename text, typename integer, std::size_t MaxEdits>
+struct LevenshteinDFA<text, integer, MaxEdits>::transition
 {
 	integer id;
 	integer next;
@@ -96,21 +125,54 @@ struct LevenshteinDFA<text, integer>::transition
 	bool operator<(const transition& s) const;
 };
 
-template<typename text, typename integer>
-LevenshteinDFA<text, integer>::state::state(){}
+template<typename text, typename integer, std::size_t MaxEdits>
+struct LevenshteinDFA<text, integer, MaxEdits>::automaton
+{
+	text pattern;
+	integer max_edits;
+
+	std::vector<state> states;
+	std::vector<transition> transitions;
+
+	// rank of each byte in the pattern; 0 for bytes not in the pattern
+	std::array<integer, dense ? 256 : 0> ranks;
+	integer width;
+	std::vector<integer> dense_transitions;
+
+	template<class nfa_type>
+	automaton(const nfa_type& nfa);
+
+	// rebuild for another NFA, reusing storage
+	template<class nfa_type>
+	void assign(const nfa_type& nfa);
+
+	template<class nfa_type>
+	void build(const nfa_type& nfa, const std::vector<symbol>& labels);
+
+	template<class nfa_type, class state_set>
+	static void start(const nfa_type& nfa, state_set& nfa_states);
+	template<class nfa_type, class state_set>
+	static void step(const nfa_type& nfa, const state_set& nfa_states, symbol c, state_set& new_nfa_states);
+
+	template<class iterator>
+	static std::size_t hash(iterator first, iterator last);
+};
+
+template<typename text, typename integer, std::size_t MaxEdits>
+LevenshteinDFA<text, integer, MaxEdits>::state::state(){}
 
-template<typename text, typename integer>
-LevenshteinDFA<text, integer>::state::state(integer start, bool match, integer edits):
-	start(start), match(match), edits(edits)
+template<typename text, typename integer, std::size_t MaxEdits>
+LevenshteinDFA<text, integer, MaxEdits>::state::state(integer start, bool match, integer edits, integer min_edits):
+	start(start), match(match), edits(edits), min_edits(min_edits)
 {}
 
-template<typename text, typename integer>
-LevenshteinDFA<text, integer>::transition::transition(integer id, integer next, symbol label):
+template<typename text, typename integer, std::size_t MaxEdits>
+LevenshteinDFA<text, integer, MaxEdits>::transition::transition(integer id, integer next, symbol label):
 	id(id), next(next), label(label)
 {}
 
-template<typename text, typename integer>
-inline bool LevenshteinDFA<text, integer>::transition::operator<(const transition& s) const
+template<typename text, typename integer, std::size_t MaxEdits>
+inline bool LevenshteinDFA<text, integer, MaxEdits>::transition::operator<(const transition& s) const
 {
 	if(id != s.id)
 		return id < s.id;
@@ -120,121 +182,314 @@ inline bool LevenshteinDFA<text, integer>::transition::operator<(const transitio
 		return next < s.next;
 }
 
-template<typename text, typename integer>
-LevenshteinDFA<text, integer>::LevenshteinDFA(const LevenshteinNFA<text>& nfa):
-	pattern(nfa.pattern), max_edits(nfa.max_edits)
+template<typename text, typename integer, std::size_t MaxEdits>
+template<class nfa_type>
+LevenshteinDFA<text, integer, MaxEdits>::automaton::automaton(const nfa_type& nfa)
 {
-	auto nfa_states = nfa.start();
-	auto nfa_transitions = nfa.transitions();
-	std::map<std::vector<nfa_state>, integer> dfa_states;
-	integer counter = 0;
-	convert(nfa, nfa_states, nfa_transitions, dfa_states, counter);
-	states.resize(counter);
-
-	std::sort(transitions.begin(), transitions.end());
-	for(typename std::vector<transition>::size_type i = 0; i < transitions.size(); ++i)
-		if(i == 0 || transitions[i - 1].id < transitions[i].id)
-			states[transitions[i].id].start = static_cast<integer>(i);
+	assign(nfa);
+}
+
+template<typename text, typename integer, std::size_t MaxEdits>
+template<class nfa_type>
+void LevenshteinDFA<text, integer, MaxEdits>::automaton::assign(const nfa_type& nfa)
+{
+	pattern = nfa.pattern;
+	max_edits = nfa.max_edits;
+	states.clear();
+	transitions.clear();
+	dense_transitions.clear();
+
+	// symbols in the pattern
+	static thread_local std::vector<symbol> labels;
+	labels.assign(pattern.begin(), pattern.end());
+	std::sort(labels.begin(), labels.end());
+	labels.erase(std::unique(labels.begin(), labels.end()), labels.end());
+
+	build(nfa, labels);
+	integer counter = static_cast<integer>(states.size());
 	// sentinel
-	states.emplace_back(static_cast<integer>(transitions.size()), false, max_edits + 1);
+	states.emplace_back(static_cast<integer>(transitions.size()), false, max_edits + 1, max_edits + 1);
+
+	if constexpr(dense){
+		ranks.fill(0);
+		width = 1;
+		for(auto label: labels)
+			ranks[static_cast<unsigned char>(label)] = width++;
+
+		// each row starts with the *-transition, which is the last one of each state
+		dense_transitions.resize(states.size() * width, counter);
+		for(integer i = 0; i < counter; ++i){
+			integer first = states[i].start, last = states[i + 1].start - 1;
+			std::fill_n(dense_transitions.begin() + i * width, width, transitions[last].next);
+			for(integer j = first; j < last; ++j)
+				dense_transitions[i * width + ranks[static_cast<unsigned char>(transitions[j].label)]] = transitions[j].next;
+		}
+	}
+}
 
+template<typename text, typename integer, std::size_t MaxEdits>
+std::shared_ptr<const typename LevenshteinDFA<text, integer, MaxEdits>::automaton>
+LevenshteinDFA<text, integer, MaxEdits>::compile(const text& pattern, integer max_edits)
+{
+	check(max_edits);
+	return std::make_shared<const automaton>(LevenshteinNFA<text>(pattern, max_edits));
+}
+
+template<typename text, typename integer, std::size_t MaxEdits>
+template<class nfa_type>
+LevenshteinDFA<text, integer, MaxEdits>::LevenshteinDFA(const nfa_type& nfa):
+	pattern(nfa.pattern), max_edits(nfa.max_edits)
+{
+	check(max_edits);
+	own = std::make_shared<automaton>(nfa);
+	dfa = own;
 	// initial state
 	current_states.push_back(0);
 }
 
-template<typename text, typename integer>
-LevenshteinDFA<text, integer>::LevenshteinDFA(const text& pattern, integer max_edits):
+template<typename text, typename integer, std::size_t MaxEdits>
+LevenshteinDFA<text, integer, MaxEdits>::LevenshteinDFA(const text& pattern, integer max_edits):
 	LevenshteinDFA(LevenshteinNFA<text>(pattern, max_edits))
 {}
 
-template<typename text, typename integer>
-constexpr const typename LevenshteinDFA<text, integer>::symbol LevenshteinDFA<text, integer>::nullchar()
+template<typename text, typename integer, std::size_t MaxEdits>
+LevenshteinDFA<text, integer, MaxEdits>::LevenshteinDFA(std::shared_ptr<const automaton> compiled):
+	pattern(compiled->pattern), max_edits(compiled->max_edits), dfa(std::move(compiled))
 {
-	return static_cast<symbol>(0);
+	check(max_edits);
+	// initial state
+	current_states.push_back(0);
 }
 
-template<typename text, typename integer>
-inline bool LevenshteinDFA<text, integer>::update(const symbol c)
+template<typename text, typename integer, std::size_t MaxEdits>
+template<class nfa_type>
+void LevenshteinDFA<text, integer, MaxEdits>::reset(const nfa_type& nfa)
 {
-	// binary search
-	integer current = states[current_states.back()].start, last = states[current_states.back() + 1].start - 1;
-	for(integer w = last - current, m; w > 16; w = m){
-		m = w >> 1;
-		current += transitions[current + m].label < c ? w - m : 0;
+	check(nfa.max_edits);
+	// rebuild in place unless a copy of this matcher still uses the automaton
+	if(own && own.use_count() == (dfa == own ? 2 : 1))
+		own->assign(nfa);
+	else
+		own = std::make_shared<automaton>(nfa);
+	dfa = own;
+	pattern = nfa.pattern;
+	max_edits = nfa.max_edits;
+	current_states.clear();
+	current_states.push_back(0);
+}
+
+template<typename text, typename integer, std::size_t MaxEdits>
+void LevenshteinDFA<text, integer, MaxEdits>::reset(const text& pattern, integer max_edits)
+{
+	reset(LevenshteinNFA<text>(pattern, max_edits));
+}
+
+template<typename text, typename integer, std::size_t MaxEdits>
+void LevenshteinDFA<text, integer, MaxEdits>::reset(std::shared_ptr<const automaton> compiled)
+{
+	check(compiled->max_edits);
+	dfa = std::move(compiled);
+	pattern = dfa->pattern;
+	max_edits = dfa->max_edits;
+	current_states.clear();
+	current_states.push_back(0);
+}
+
+template<typename text, typename integer, std::size_t MaxEdits>
+inline void LevenshteinDFA<text, integer, MaxEdits>::check(integer max_edits)
+{
+	if constexpr(fixed){
+		if(max_edits != MaxEdits)
+			throw std::invalid_argument("LevenshteinDFA: max_edits must be equal to MaxEdits");
 	}
-	// linear search
-	for(; current < last && transitions[current].label < c; ++current);
+}
 
-	current = transitions[transitions[current].label == c ? current : last].next;
-	bool updatable = states[current].edits <= max_edits;
+template<typename text, typename integer, std::size_t MaxEdits>
+constexpr const typename LevenshteinDFA<text, integer, MaxEdits>::symbol LevenshteinDFA<text, integer, MaxEdits>::nullchar()
+{
+	return static_cast<symbol>(0);
+}
+
+template<typename text, typename integer, std::size_t MaxEdits>
+inline bool LevenshteinDFA<text, integer, MaxEdits>::update(const symbol c)
+{
+	const auto& states = dfa->states;
+	integer current;
+	if constexpr(dense){
+		current = dfa->dense_transitions[current_states.back() * dfa->width + dfa->ranks[static_cast<unsigned char>(c)]];
+	}
+	else{
+		// binary search
+		const auto& transitions = dfa->transitions;
+		current = states[current_states.back()].start;
+		integer last = states[current_states.back() + 1].start - 1;
+		for(integer w = last - current, m; w > 16; w = m){
+			m = w >> 1;
+			current += transitions[current + m].label < c ? w - m : 0;
+		}
+		// linear search
+		for(; current < last && transitions[current].label < c; ++current);
+
+		current = transitions[transitions[current].label == c ? current : last].next;
+	}
+	bool updatable;
+	if constexpr(fixed)
+		updatable = states[current].edits <= MaxEdits;
+	else
+		updatable = states[current].edits <= max_edits;
 	if(updatable)
 		current_states.push_back(current);
 
 	return updatable;
 }
 
-template<typename text, typename integer>
-inline bool LevenshteinDFA<text, integer>::matched() const
+template<typename text, typename integer, std::size_t MaxEdits>
+inline bool LevenshteinDFA<text, integer, MaxEdits>::matched() const
 {
-	return states[current_states.back()].match;
+	return dfa->states[current_states.back()].match;
 }
 
-template<typename text, typename integer>
-inline void LevenshteinDFA<text, integer>::back()
+template<typename text, typename integer, std::size_t MaxEdits>
+inline void LevenshteinDFA<text, integer, MaxEdits>::back()
 {
 	if(current_states.size() > 1)
 		current_states.pop_back();
 }
 
-template<typename text, typename integer>
-inline integer LevenshteinDFA<text, integer>::max_distance() const
+template<typename text, typename integer, std::size_t MaxEdits>
+inline integer LevenshteinDFA<text, integer, MaxEdits>::max_distance() const
 {
-	return max_edits;
+	if constexpr(fixed)
+		return MaxEdits;
+	else
+		return max_edits;
 }
 
-template<typename text, typename integer>
-inline integer LevenshteinDFA<text, integer>::distance() const
+template<typename text, typename integer, std::size_t MaxEdits>
+inline integer LevenshteinDFA<text, integer, MaxEdits>::distance() const
 {
-	return states[current_states.back()].edits;
+	return dfa->states[current_states.back()].edits;
 }
 
-template<typename text, typename integer>
-integer LevenshteinDFA<text, integer>::convert(const LevenshteinNFA<text>& nfa,
-	const std::vector<nfa_state>& nfa_states, const std::set<symbol>& nfa_transitions,
-	std::map<std::vector<nfa_state>, integer>& dfa_states, integer& counter)
+template<typename text, typename integer, std::size_t MaxEdits>
+inline integer LevenshteinDFA<text, integer, MaxEdits>::min_distance() const
 {
-	// skip if current DFA state already exists
-	const auto p = dfa_states.find(nfa_states);
-	if(p != dfa_states.end())
-		return p->second;
-
-	integer created_state = counter++;
-	dfa_states.insert(p, std::make_pair(nfa_states, created_state));
+	return dfa->states[current_states.back()].min_edits;
+}
 
-	bool match = nfa.is_match(nfa_states);
-	integer edits = max_edits + 1;
-	for(const auto& n: nfa_states){
-		if(!match)
-			edits = std::min(edits, static_cast<integer>(n.second));
-		else if(n.first == static_cast<integer>(nfa.pattern.size()))
-			edits = std::min(edits, static_cast<integer>(n.second));
-	}
-	states.emplace_back(0, match, edits); // state.start will be updated later
-
-	// *-transition
-	auto new_nfa_states = nfa.step(nfa_states, nullchar());
-	auto next0 = convert(nfa, new_nfa_states, nfa_transitions, dfa_states, counter);
-	transitions.emplace_back(created_state, next0, nullchar());
-
-	// check other transitions with symbols in the pattern
-	for(auto label: nfa_transitions){
-		auto new_nfa_states = nfa.step(nfa_states, label);
-		auto next = convert(nfa, new_nfa_states, nfa_transitions, dfa_states, counter);
-		if(next != next0)
-			transitions.emplace_back(created_state, next, label);
+// breadth-first subset construction; DFA states are numbered in the order of discovery
+template<typename text, typename integer, std::size_t MaxEdits>
+template<class nfa_type>
+void LevenshteinDFA<text, integer, MaxEdits>::automaton::build(const nfa_type& nfa, const std::vector<symbol>& labels)
+{
+	using nfa_state = typename nfa_type::state;
+	constexpr integer empty = static_cast<integer>(-1);
+
+	// with fixed MaxEdits, NFA states of Levenshtein and Damerau-Levenshtein automata stay within
+	// 2 * MaxEdits + 1 positions, at most two states each, so they are kept in fixed-size arrays
+	using bounded_state_set = bounded_vector<nfa_state, fixed ? 2 * (2 * MaxEdits + 1) : 1>;
+	using state_set = std::conditional_t<fixed &&
+		requires(const nfa_type& n, const bounded_state_set& s, bounded_state_set& t, symbol c){ n.start(t); n.step(s, c, t); },
+		bounded_state_set, std::vector<nfa_state>>;
+
+	// scratch buffers are kept per thread so that rebuilding does not allocate after warm-up
+	// NFA states of all DFA states, packed into one array
+	static thread_local std::vector<nfa_state> packed;
+	static thread_local std::vector<std::size_t> offsets;
+	// open addressing hash table of DFA state ids
+	static thread_local std::vector<integer> slots;
+	static thread_local state_set nfa_states, new_nfa_states;
+	packed.clear();
+	offsets.assign(1, 0);
+	slots.assign(64, empty);
+
+	auto find_or_add = [&](const state_set& s) -> integer
+	{
+		std::size_t mask = slots.size() - 1;
+		std::size_t i = hash(s.begin(), s.end()) & mask;
+		for(; slots[i] != empty; i = (i + 1) & mask)
+			if(std::equal(s.begin(), s.end(), packed.begin() + offsets[slots[i]], packed.begin() + offsets[slots[i] + 1]))
+				return slots[i];
+
+		integer id = static_cast<integer>(offsets.size() - 1);
+		packed.insert(packed.end(), s.begin(), s.end());
+		offsets.push_back(packed.size());
+		slots[i] = id;
+
+		// keep the load factor at most 1/2
+		if(2 * offsets.size() > slots.size()){
+			slots.assign(2 * slots.size(), empty);
+			mask = slots.size() - 1;
+			for(integer j = 0; j <= id; ++j){
+				std::size_t k = hash(packed.begin() + offsets[j], packed.begin() + offsets[j + 1]) & mask;
+				for(; slots[k] != empty; k = (k + 1) & mask);
+				slots[k] = j;
+			}
+		}
+		return id;
+	};
+
+	start(nfa, nfa_states);
+	find_or_add(nfa_states);
+	for(integer id = 0; id + 1 < offsets.size(); ++id){
+		nfa_states.assign(packed.begin() + offsets[id], packed.begin() + offsets[id + 1]);
+
+		bool match = nfa.is_match(nfa_states);
+		integer edits = max_edits + 1, min_edits = max_edits + 1;
+		for(const auto& n: nfa_states){
+			min_edits = std::min(min_edits, static_cast<integer>(std::get<1>(n)));
+			if(match && std::get<0>(n) == static_cast<integer>(nfa.pattern.size()))
+				edits = std::min(edits, static_cast<integer>(std::get<1>(n)));
+		}
+		states.emplace_back(static_cast<integer>(transitions.size()), match, match ? edits : min_edits, min_edits);
+
+		// *-transition
+		step(nfa, nfa_states, nullchar(), new_nfa_states);
+		integer next0 = find_or_add(new_nfa_states);
+
+		// transitions with symbols in the pattern in ascending order, followed by the *-transition
+		for(auto label: labels){
+			step(nfa, nfa_states, label, new_nfa_states);
+			integer next = find_or_add(new_nfa_states);
+			if(next != next0)
+				transitions.emplace_back(id, next, label);
+		}
+		transitions.emplace_back(id, next0, nullchar());
 	}
+}
 
-	return created_state;
+template<typename text, typename integer, std::size_t MaxEdits>
+template<class nfa_type, class state_set>
+inline void LevenshteinDFA<text, integer, MaxEdits>::automaton::start(const nfa_type& nfa, state_set& nfa_states)
+{
+	if constexpr(requires{ nfa.start(nfa_states); })
+		nfa.start(nfa_states);
+	else
+		nfa_states = nfa.start();
+}
+
+template<typename text, typename integer, std::size_t MaxEdits>
+template<class nfa_type, class state_set>
+inline void LevenshteinDFA<text, integer, MaxEdits>::automaton::step(const nfa_type& nfa,
+	const state_set& nfa_states, symbol c, state_set& new_nfa_states)
+{
+	// reuse the buffer if the NFA supports it
+	if constexpr(requires{ nfa.step(nfa_states, c, new_nfa_states); })
+		nfa.step(nfa_states, c, new_nfa_states);
+	else
+		new_nfa_states = nfa.step(nfa_states, c);
+}
+
+template<typename text, typename integer, std::size_t MaxEdits>
+template<class iterator>
+inline std::size_t LevenshteinDFA<text, integer, MaxEdits>::automaton::hash(iterator first, iterator last)
+{
+	std::size_t h = 14695981039346656037ull;
+	for(; first != last; ++first)
+		std::apply([&h](const auto&... values){
+			((h = (h ^ static_cast<std::size_t>(values)) * 1099511628211ull), ...);
+		}, *first);
+	return h ^ (h >> 32);
 }
 
 }
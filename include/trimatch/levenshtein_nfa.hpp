@@ -52,14 +52,31 @@ public:
 	std::vector<state> start() const
 	{
 		std::vector<state> states;
-		for(integer i = 0; i <= max_edits; ++i)
-			states.emplace_back(i, i);
+		start(states);
 		return states;
 	}
 
+	// state_set is std::vector<state> or any container with the same interface
+	template<class state_set>
+	void start(state_set& states) const
+	{
+		states.clear();
+		for(integer i = 0; i <= max_edits && i <= pattern.size(); ++i)
+			states.emplace_back(i, i);
+	}
+
 	std::vector<state> step(const std::vector<state>& states, symbol c) const
 	{
 		std::vector<state> new_states;
+		step(states, c, new_states);
+		return new_states;
+	}
+
+	// writes the next states into new_states to reuse its storage
+	template<class state_set>
+	void step(const state_set& states, symbol c, state_set& new_states) const
+	{
+		new_states.clear();
 		if(!states.empty() && states.front().first == 0 && states.front().second < max_edits)
 			new_states.emplace_back(0, states.front().second + 1);
 
@@ -75,11 +92,10 @@ public:
 			if(d <= max_edits)
 				new_states.emplace_back(i + 1, d);
 		}
-
-		return new_states;
 	}
 
-	bool is_match(const std::vector<state>& states) const
+	template<class state_set>
+	bool is_match(const state_set& states) const
 	{
 		return !states.empty() && states.back().first == pattern.size();
 	}
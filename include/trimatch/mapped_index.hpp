@@ -0,0 +1,159 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Index used in place from a memory-mapped file written by index::save_mapped()
+
+Opening an index maps the file read-only and reads only its header and the offsets of children,
+which are checked against the size of the file, and processes using the same file share its pages
+in the page cache.
+The file must not be modified while it is mapped, or reads fault with SIGBUS; replace it by
+renaming a new file over it, as index::save_mapped(path) does.
+*/
+
+#ifndef TRIMATCH_MAPPED_INDEX
+#define TRIMATCH_MAPPED_INDEX
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <sftrie/util.hpp>
+
+#include "mapped_trie.hpp"
+#include "levenshtein_dfa.hpp"
+#include "search_client.hpp"
+
+namespace trimatch{
+
+// read-only mapping of a whole file
+class mapped_file
+{
+public:
+	mapped_file(const std::string& path);
+	mapped_file(mapped_file&& f) noexcept;
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+	~mapped_file();
+
+	const void* data() const;
+	std::size_t size() const;
+
+private:
+	void* address;
+	std::size_t length;
+};
+
+template<
+	class text,
+	class item = sftrie::empty,
+	class integer = std::uint32_t,
+	class approximate_matcher = LevenshteinDFA<text, integer>
+>
+class mapped_index
+{
+public:
+	using text_type = text;
+	using item_type = item;
+	using integer_type = integer;
+	using trie_type = mapped_trie<text, item, integer>;
+	using value_type = typename trie_type::value_type;
+	using matcher_type = approximate_matcher;
+	using searcher_type = search_client<trie_type, approximate_matcher>;
+
+	mapped_index(const std::string& path);
+
+	searcher_type searcher() const;
+
+	const trie_type& raw_trie() const;
+
+private:
+	mapped_file file;
+	trie_type T;
+};
+
+inline mapped_file::mapped_file(const std::string& path):
+	address(nullptr), length(0)
+{
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		throw std::runtime_error("mapped_file: cannot open " + path);
+	struct stat st;
+	if(::fstat(fd, &st) != 0 || st.st_size == 0){
+		::close(fd);
+		throw std::runtime_error("mapped_file: cannot map " + path);
+	}
+	length = static_cast<std::size_t>(st.st_size);
+	address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if(address == MAP_FAILED){
+		address = nullptr;
+		throw std::runtime_error("mapped_file: cannot map " + path);
+	}
+}
+
+inline mapped_file::mapped_file(mapped_file&& f) noexcept:
+	address(std::exchange(f.address, nullptr)), length(std::exchange(f.length, 0))
+{}
+
+inline mapped_file::~mapped_file()
+{
+	if(address != nullptr)
+		::munmap(address, length);
+}
+
+inline const void* mapped_file::data() const
+{
+	return address;
+}
+
+inline std::size_t mapped_file::size() const
+{
+	return length;
+}
+
+template<class text, class item, class integer, class approximate_matcher>
+mapped_index<text, item, integer, approximate_matcher>::mapped_index(const std::string& path):
+	file(path), T(file.data(), file.size())
+{}
+
+template<class text, class item, class integer, class approximate_matcher>
+typename mapped_index<text, item, integer, approximate_matcher>::searcher_type
+mapped_index<text, item, integer, approximate_matcher>::searcher() const
+{
+	return searcher_type(T);
+}
+
+template<class text, class item, class integer, class approximate_matcher>
+const typename mapped_index<text, item, integer, approximate_matcher>::trie_type&
+mapped_index<text, item, integer, approximate_matcher>::raw_trie() const
+{
+	return T;
+}
+
+}
+
+#endif
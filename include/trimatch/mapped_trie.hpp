@@ -0,0 +1,563 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Read-only trie over a flat, alignment-aware layout which can be used in place, e.g. from mapped memory
+
+Nodes are numbered in breadth-first order, so the children of node i are nodes next[i] to next[i + 1] - 1,
+in the order of their labels.
+The file begins with a header, followed by next (node_size + 1 integers), labels (node_size symbols),
+flags (node_size bytes; bit 0: match) and, for maps, values (node_size items). Each array starts at
+an offset aligned to 64 bytes.
+*/
+
+#ifndef TRIMATCH_MAPPED_TRIE
+#define TRIMATCH_MAPPED_TRIE
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <array>
+#include <iterator>
+#include <ios>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+
+#include <sftrie/util.hpp>
+
+namespace trimatch{
+
+template<typename text, typename item = sftrie::empty, typename integer = std::uint32_t>
+class mapped_trie
+{
+public:
+	using text_type = text;
+	using item_type = item;
+	using integer_type = integer;
+	using symbol = typename text::value_type;
+	static constexpr bool has_values = !std::is_same_v<item, sftrie::empty>;
+	using value_type = std::conditional_t<has_values, item, bool>;
+
+	static_assert(std::is_trivially_copyable_v<symbol> && std::is_trivially_copyable_v<value_type>,
+		"mapped_trie: symbols and values must be trivially copyable");
+
+	class node_type;
+	class child_iterator;
+	class prefix_iterator;
+	class subtree_iterator;
+	class common_searcher;
+
+	// uses size bytes at data, which must be aligned to 64 bytes and outlive this trie;
+	// checks the header and next so that a broken layout cannot lead to reads outside data
+	mapped_trie(const void* data, std::size_t size);
+
+	// writes T in this layout
+	template<class trie, typename output_stream>
+	static void save(const trie& T, output_stream& os);
+
+	node_type root() const;
+	bool exists(const text& query) const;
+	// node of the query; the root if the query is not a prefix of any key
+	node_type find(const text& query) const;
+	common_searcher searcher() const;
+
+	std::size_t node_size() const;
+	std::size_t total_space() const;
+
+private:
+	static constexpr std::uint64_t alignment = 64;
+	static constexpr std::array<char, 8> magic = {'T', 'R', 'I', 'M', 'A', 'T', 'C', 'H'};
+	static constexpr std::uint32_t version = 1;
+	static constexpr std::uint32_t byte_order = 0x01020304;
+
+	struct header
+	{
+		std::array<char, 8> magic;
+		std::uint32_t version;
+		std::uint32_t byte_order;
+		std::uint32_t symbol_size;
+		std::uint32_t integer_size;
+		std::uint32_t value_size;
+		std::uint32_t reserved;
+		std::uint64_t node_size;
+		std::uint64_t next_offset;
+		std::uint64_t labels_offset;
+		std::uint64_t flags_offset;
+		std::uint64_t values_offset;
+		std::uint64_t total_size;
+
+		bool operator==(const header&) const = default;
+	};
+
+	static constexpr std::uint8_t match_flag = 1;
+
+	std::size_t size;
+	std::size_t nodes;
+	const integer* next;
+	const symbol* labels;
+	const std::uint8_t* flags;
+	const value_type* values;
+
+	static std::uint64_t align(std::uint64_t offset);
+	static header layout(std::uint64_t node_size);
+	// index of the child of node labeled c, or 0 if there is none
+	integer child(integer node, symbol c) const;
+	// order of labels of siblings, which is the order of sorted keys
+	static bool precedes(symbol a, symbol b);
+};
+
+template<typename text, typename item, typename integer>
+class mapped_trie<text, item, integer>::node_type
+{
+public:
+	node_type(const mapped_trie& T, integer node):
+		T(&T), node(node)
+	{}
+
+	integer id() const
+	{
+		return node;
+	}
+
+	symbol label() const
+	{
+		return T->labels[node];
+	}
+
+	bool match() const
+	{
+		return (T->flags[node] & match_flag) != 0;
+	}
+
+	bool leaf() const
+	{
+		return T->next[node] == T->next[node + 1];
+	}
+
+	value_type value() const
+	{
+		if constexpr(has_values)
+			return T->values[node];
+		else
+			return match();
+	}
+
+	child_iterator children() const
+	{
+		return child_iterator(*T, T->next[node], T->next[node + 1]);
+	}
+
+private:
+	const mapped_trie* T;
+	integer node;
+};
+
+// siblings from current to last - 1; also a range of them
+template<typename text, typename item, typename integer>
+class mapped_trie<text, item, integer>::child_iterator
+{
+public:
+	using value_type = node_type;
+	using difference_type = std::ptrdiff_t;
+
+	// the root alone
+	child_iterator(const mapped_trie& T):
+		child_iterator(T, 0, 1)
+	{}
+
+	child_iterator(const mapped_trie& T, integer current, integer last):
+		T(&T), current(current), last(last)
+	{}
+
+	child_iterator begin() const
+	{
+		return *this;
+	}
+
+	child_iterator end() const
+	{
+		return child_iterator(*T, last, last);
+	}
+
+	node_type operator*() const
+	{
+		return node_type(*T, current);
+	}
+
+	child_iterator& operator++()
+	{
+		++current;
+		return *this;
+	}
+
+	child_iterator operator++(int)
+	{
+		auto i = *this;
+		++current;
+		return i;
+	}
+
+	bool incrementable() const
+	{
+		return current + 1 < last;
+	}
+
+	bool operator==(const child_iterator& i) const
+	{
+		return current == i.current;
+	}
+
+private:
+	const mapped_trie* T;
+	integer current;
+	integer last;
+};
+
+// keys which are prefixes of the query, shortest first; dereferences to itself
+template<typename text, typename item, typename integer>
+class mapped_trie<text, item, integer>::prefix_iterator
+{
+public:
+	prefix_iterator(const mapped_trie& T, const text& query):
+		T(&T), query(query), depth(0), current(0)
+	{
+		if(!node_type(T, 0).match())
+			++*this;
+	}
+
+	prefix_iterator& begin()
+	{
+		return *this;
+	}
+
+	std::default_sentinel_t end() const
+	{
+		return std::default_sentinel;
+	}
+
+	bool operator==(std::default_sentinel_t) const
+	{
+		return depth > query.size();
+	}
+
+	const prefix_iterator& operator*() const
+	{
+		return *this;
+	}
+
+	prefix_iterator& operator++()
+	{
+		do{
+			if(depth == query.size() || (current = T->child(current, query[depth])) == 0)
+				depth = query.size();
+			++depth;
+		}while(depth <= query.size() && !node().match());
+		return *this;
+	}
+
+	text key() const
+	{
+		return text(query.begin(), query.begin() + depth);
+	}
+
+	node_type node() const
+	{
+		return node_type(*T, current);
+	}
+
+	value_type value() const
+	{
+		return node().value();
+	}
+
+private:
+	const mapped_trie* T;
+	text query;
+	std::size_t depth;
+	integer current;
+};
+
+// keys starting with the query in depth-first order; dereferences to itself
+template<typename text, typename item, typename integer>
+class mapped_trie<text, item, integer>::subtree_iterator
+{
+public:
+	subtree_iterator(const mapped_trie& T, const text& query):
+		T(&T), current(query)
+	{
+		integer node = 0;
+		for(const auto c: query)
+			if((node = T.child(node, c)) == 0)
+				return;
+		path.emplace_back(T, node, node + 1);
+		if(!this->node().match())
+			++*this;
+	}
+
+	subtree_iterator& begin()
+	{
+		return *this;
+	}
+
+	std::default_sentinel_t end() const
+	{
+		return std::default_sentinel;
+	}
+
+	bool operator==(std::default_sentinel_t) const
+	{
+		return path.empty();
+	}
+
+	const subtree_iterator& operator*() const
+	{
+		return *this;
+	}
+
+	subtree_iterator& operator++()
+	{
+		do{
+			auto n = node();
+			if(!n.leaf()){
+				path.push_back(n.children());
+				current.push_back((*path.back()).label());
+				continue;
+			}
+			while(!path.empty() && !path.back().incrementable()){
+				path.pop_back();
+				if(!path.empty())
+					current.pop_back();
+			}
+			if(path.empty())
+				break;
+			++path.back();
+			current.back() = (*path.back()).label();
+		}while(!node().match());
+		return *this;
+	}
+
+	const text& key() const
+	{
+		return current;
+	}
+
+	node_type node() const
+	{
+		return *path.back();
+	}
+
+	value_type value() const
+	{
+		return node().value();
+	}
+
+private:
+	const mapped_trie* T;
+	std::vector<child_iterator> path;
+	text current;
+};
+
+template<typename text, typename item, typename integer>
+class mapped_trie<text, item, integer>::common_searcher
+{
+public:
+	common_searcher(const mapped_trie& T):
+		T(&T)
+	{}
+
+	prefix_iterator prefix(const text& query)
+	{
+		return prefix_iterator(*T, query);
+	}
+
+	subtree_iterator predict(const text& query)
+	{
+		return subtree_iterator(*T, query);
+	}
+
+private:
+	const mapped_trie* T;
+};
+
+template<typename text, typename item, typename integer>
+mapped_trie<text, item, integer>::mapped_trie(const void* data, std::size_t size):
+	size(size)
+{
+	header h;
+	if(size < sizeof(h))
+		throw std::runtime_error("mapped_trie: file is too short");
+	std::memcpy(&h, data, sizeof(h));
+	if(h.magic != magic || h.version != version)
+		throw std::runtime_error("mapped_trie: unknown format");
+	if(h.byte_order != byte_order || h.symbol_size != sizeof(symbol) || h.integer_size != sizeof(integer) ||
+			h.value_size != (has_values ? sizeof(value_type) : 0))
+		throw std::runtime_error("mapped_trie: incompatible types or byte order");
+	if(h.node_size == 0 || h.total_size > size || h != layout(h.node_size))
+		throw std::runtime_error("mapped_trie: broken header");
+	if(reinterpret_cast<std::uintptr_t>(data) % alignment != 0)
+		throw std::runtime_error("mapped_trie: data is not aligned");
+
+	const char* base = static_cast<const char*>(data);
+	nodes = static_cast<std::size_t>(h.node_size);
+	next = reinterpret_cast<const integer*>(base + h.next_offset);
+	labels = reinterpret_cast<const symbol*>(base + h.labels_offset);
+	flags = reinterpret_cast<const std::uint8_t*>(base + h.flags_offset);
+	values = has_values ? reinterpret_cast<const value_type*>(base + h.values_offset) : nullptr;
+
+	// children follow their parent and the last node has no sibling after it
+	if(next[0] != 1 || next[nodes] != nodes)
+		throw std::runtime_error("mapped_trie: broken node offsets");
+	for(std::size_t i = 0; i < nodes; ++i)
+		if(next[i] <= i || next[i] > next[i + 1])
+			throw std::runtime_error("mapped_trie: broken node offsets");
+}
+
+template<typename text, typename item, typename integer>
+template<class trie, typename output_stream>
+void mapped_trie<text, item, integer>::save(const trie& T, output_stream& os)
+{
+	// breadth-first order
+	std::vector<typename trie::node_type> order = {T.root()};
+	std::vector<integer> first;
+	for(std::size_t i = 0; i < order.size(); ++i){
+		first.push_back(static_cast<integer>(order.size()));
+		if(!order[i].leaf())
+			for(const auto& n: order[i].children())
+				order.push_back(n);
+	}
+	first.push_back(static_cast<integer>(order.size()));
+
+	header h = layout(order.size());
+	std::uint64_t written = 0;
+	auto write = [&](const void* data, std::uint64_t bytes){
+		os.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+		written += bytes;
+	};
+	auto pad = [&](std::uint64_t offset){
+		static constexpr std::array<char, alignment> zeros = {};
+		write(zeros.data(), offset - written);
+	};
+
+	write(&h, sizeof(h));
+	pad(h.next_offset);
+	write(first.data(), sizeof(integer) * first.size());
+	pad(h.labels_offset);
+	for(const auto& n: order){
+		symbol c = &n == &order.front() ? symbol() : static_cast<symbol>(n.label());
+		write(&c, sizeof(c));
+	}
+	pad(h.flags_offset);
+	for(const auto& n: order){
+		std::uint8_t f = n.match() ? match_flag : 0;
+		write(&f, sizeof(f));
+	}
+	if constexpr(has_values){
+		pad(h.values_offset);
+		for(const auto& n: order){
+			value_type v = n.value();
+			write(&v, sizeof(v));
+		}
+	}
+	pad(h.total_size);
+}
+
+template<typename text, typename item, typename integer>
+inline std::uint64_t mapped_trie<text, item, integer>::align(std::uint64_t offset)
+{
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+template<typename text, typename item, typename integer>
+typename mapped_trie<text, item, integer>::header mapped_trie<text, item, integer>::layout(std::uint64_t node_size)
+{
+	header h = {magic, version, byte_order, sizeof(symbol), sizeof(integer), has_values ? sizeof(value_type) : 0, 0,
+		node_size, 0, 0, 0, 0, 0};
+	h.next_offset = align(sizeof(header));
+	h.labels_offset = align(h.next_offset + sizeof(integer) * (node_size + 1));
+	h.flags_offset = align(h.labels_offset + sizeof(symbol) * node_size);
+	h.values_offset = has_values ? align(h.flags_offset + node_size) : 0;
+	h.total_size = align(has_values ? h.values_offset + sizeof(value_type) * node_size : h.flags_offset + node_size);
+	return h;
+}
+
+template<typename text, typename item, typename integer>
+typename mapped_trie<text, item, integer>::node_type mapped_trie<text, item, integer>::root() const
+{
+	return node_type(*this, 0);
+}
+
+template<typename text, typename item, typename integer>
+bool mapped_trie<text, item, integer>::exists(const text& query) const
+{
+	auto node = find(query);
+	return (query.empty() || node.id() != 0) && node.match();
+}
+
+template<typename text, typename item, typename integer>
+typename mapped_trie<text, item, integer>::node_type mapped_trie<text, item, integer>::find(const text& query) const
+{
+	integer node = 0;
+	for(const auto c: query)
+		if((node = child(node, c)) == 0)
+			break;
+	return node_type(*this, node);
+}
+
+template<typename text, typename item, typename integer>
+typename mapped_trie<text, item, integer>::common_searcher mapped_trie<text, item, integer>::searcher() const
+{
+	return common_searcher(*this);
+}
+
+template<typename text, typename item, typename integer>
+std::size_t mapped_trie<text, item, integer>::node_size() const
+{
+	return nodes;
+}
+
+template<typename text, typename item, typename integer>
+std::size_t mapped_trie<text, item, integer>::total_space() const
+{
+	return size;
+}
+
+// the root is never a child, so 0 means not found
+template<typename text, typename item, typename integer>
+inline integer mapped_trie<text, item, integer>::child(integer node, symbol c) const
+{
+	const symbol* first = labels + next[node];
+	const symbol* last = labels + next[node + 1];
+	const symbol* p = std::lower_bound(first, last, c, precedes);
+	return p != last && *p == c ? static_cast<integer>(p - labels) : 0;
+}
+
+template<typename text, typename item, typename integer>
+inline bool mapped_trie<text, item, integer>::precedes(symbol a, symbol b)
+{
+	if constexpr(requires{ typename text::traits_type; })
+		return text::traits_type::lt(a, b);
+	else
+		return a < b;
+}
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Arrays of values for each node of a trie, saved and loaded together
+*/
+
+#ifndef TRIMATCH_NODE_ANNOTATION
+#define TRIMATCH_NODE_ANNOTATION
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <ios>
+
+#include "readable.hpp"
+
+namespace trimatch{
+
+template<typename value_type, std::size_t arrays>
+class node_annotation
+{
+public:
+	void clear();
+
+	bool empty() const;
+
+	std::size_t space() const;
+
+	template<typename output_stream>
+	void save(output_stream& os) const;
+	template<readable input_stream>
+	void load(input_stream& is);
+
+protected:
+	// data[i][id] is the i-th value of node id
+	std::array<std::vector<value_type>, arrays> data;
+};
+
+template<typename value_type, std::size_t arrays>
+void node_annotation<value_type, arrays>::clear()
+{
+	for(auto& values: data)
+		values.clear();
+}
+
+template<typename value_type, std::size_t arrays>
+inline bool node_annotation<value_type, arrays>::empty() const
+{
+	return data[0].empty();
+}
+
+template<typename value_type, std::size_t arrays>
+std::size_t node_annotation<value_type, arrays>::space() const
+{
+	return sizeof(value_type) * arrays * data[0].size();
+}
+
+template<typename value_type, std::size_t arrays>
+template<typename output_stream>
+void node_annotation<value_type, arrays>::save(output_stream& os) const
+{
+	std::uint64_t size = data[0].size();
+	os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+	for(const auto& values: data)
+		os.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(sizeof(value_type) * size));
+}
+
+template<typename value_type, std::size_t arrays>
+template<readable input_stream>
+void node_annotation<value_type, arrays>::load(input_stream& is)
+{
+	std::uint64_t size = 0;
+	is.read(reinterpret_cast<char*>(&size), sizeof(size));
+	for(auto& values: data){
+		values.resize(size);
+		is.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(sizeof(value_type) * size));
+	}
+}
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Executors which run the workers of a parallel search
+*/
+
+#ifndef TRIMATCH_PARALLEL_EXECUTOR
+#define TRIMATCH_PARALLEL_EXECUTOR
+
+#include <cstddef>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <system_error>
+#include <concepts>
+#include <algorithm>
+
+namespace trimatch{
+
+// run(work) calls work() on up to concurrency() threads, which may include the calling one, and returns
+// when every call has returned; work() does not throw, so a pool of threads can be used across searches
+template<typename executor>
+concept parallel_executor = requires(executor& e, const std::function<void()>& work)
+{
+	{ e.concurrency() } -> std::convertible_to<std::size_t>;
+	e.run(work);
+};
+
+// starts threads for each run() and joins them; a pool avoids this cost for many short searches
+class thread_executor
+{
+public:
+	// 0: hardware concurrency
+	thread_executor(std::size_t threads = 0);
+
+	std::size_t concurrency() const;
+	void run(const std::function<void()>& work) const;
+
+private:
+	std::size_t threads;
+};
+
+inline thread_executor::thread_executor(std::size_t threads):
+	threads(threads > 0 ? threads : std::max<std::size_t>(std::thread::hardware_concurrency(), 1))
+{}
+
+inline std::size_t thread_executor::concurrency() const
+{
+	return threads;
+}
+
+inline void thread_executor::run(const std::function<void()>& work) const
+{
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	try{
+		for(std::size_t i = 1; i < threads; ++i)
+			workers.emplace_back(work);
+	}
+	catch(const std::system_error&){
+		// fewer threads than requested; the calling thread takes the rest of the work
+	}
+	work();
+	for(auto& worker: workers)
+		worker.join();
+}
+
+}
+
+#endif
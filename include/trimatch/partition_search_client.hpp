@@ -0,0 +1,188 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Approximate search for large edit distances by partitioning the query
+
+If a key x is within k edits of a query q = q1 q2, then x = x1 x2 with
+ed(q1, x1) + ed(q2, x2) <= k, so either ed(q1, x1) <= k / 2 for a prefix x1
+or ed(q2, x2) <= k / 2 for a suffix x2 (pigeonhole principle). The first case
+is searched on the trie of keys and the second on a trie of reversed keys.
+On each path, a matcher for the half with k / 2 edits must accept a prefix
+of the path before it may leave the matcher of the whole query with k edits,
+so only paths near a seed are traversed and no automaton for k edits is built.
+See Mihov and Schulz, https://doi.org/10.1162/0891201042544938
+*/
+
+#ifndef TRIMATCH_PARTITION_SEARCH_CLIENT
+#define TRIMATCH_PARTITION_SEARCH_CLIENT
+
+#include <cstddef>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <stdexcept>
+
+#include "reversed_keys.hpp"
+#include "levenshtein_dfa.hpp"
+#include "bit_parallel_matcher.hpp"
+
+namespace trimatch{
+
+template<
+	class trie,
+	class seed_matcher = LevenshteinDFA<typename trie::text_type, typename trie::integer_type>,
+	class verifier = BitParallelMatcher<typename trie::text_type, typename trie::integer_type>
+>
+class partition_search_client
+{
+private:
+	using text = typename trie::text_type;
+	using integer = typename trie::integer_type;
+	using reversed_trie = typename reversed_keys<text, typename trie::value_type, integer>::trie_type;
+
+public:
+	using value_type = typename trie::value_type;
+
+	// R must be built from T; throws std::invalid_argument if R is not built or has another number of keys
+	partition_search_client(const trie& T, const reversed_keys<text, value_type, integer>& R);
+
+	// same results as search_client::approx(), in ascending order of keys
+	template<class back_insert_iterator>
+	void approx(const text& query, integer max_edits, back_insert_iterator bi) const;
+
+private:
+	const trie& T;
+	const reversed_trie& R;
+
+	static const reversed_trie& checked(const trie& T, const reversed_keys<text, value_type, integer>& R);
+	template<class node_type>
+	static integer count_keys(node_type node);
+
+	// calls found(key, node, edits) for keys whose prefix is accepted by seed
+	template<class node_type, class callback>
+	static void traverse(node_type node, seed_matcher& seed, bool seeded, verifier& whole,
+		text& current, callback& found);
+};
+
+template<class trie, class seed_matcher, class verifier>
+partition_search_client<trie, seed_matcher, verifier>::partition_search_client(
+	const trie& T, const reversed_keys<text, value_type, integer>& R):
+	T(T), R(checked(T, R))
+{}
+
+template<class trie, class seed_matcher, class verifier>
+const typename partition_search_client<trie, seed_matcher, verifier>::reversed_trie&
+partition_search_client<trie, seed_matcher, verifier>::checked(
+	const trie& T, const reversed_keys<text, value_type, integer>& R)
+{
+	if(R.empty())
+		throw std::invalid_argument("partition_search_client requires built reversed keys");
+	if(R.counts().count(R.trie().root().id()) != count_keys(T.root()))
+		throw std::invalid_argument("partition_search_client requires reversed keys of the same trie");
+	return R.trie();
+}
+
+template<class trie, class seed_matcher, class verifier>
+template<class node_type>
+typename partition_search_client<trie, seed_matcher, verifier>::integer
+partition_search_client<trie, seed_matcher, verifier>::count_keys(node_type node)
+{
+	integer n = node.match() ? 1 : 0;
+	if(!node.leaf())
+		for(const auto& c: node.children())
+			n += count_keys(c);
+	return n;
+}
+
+template<class trie, class seed_matcher, class verifier>
+template<class back_insert_iterator>
+void partition_search_client<trie, seed_matcher, verifier>::approx(
+	const text& query, integer max_edits, back_insert_iterator bi) const
+{
+	integer seed_edits = max_edits / 2;
+	std::size_t half = (query.size() + 1) / 2;
+	text first(query.begin(), query.begin() + half), second(query.begin() + half, query.end());
+	text reversed_query(query.rbegin(), query.rend());
+	std::reverse(second.begin(), second.end());
+
+	std::vector<std::tuple<text, value_type, integer>> results;
+	auto by_key = [](const auto& a, const auto& b){ return std::get<0>(a) < std::get<0>(b); };
+	text current;
+
+	// keys with a prefix close to the first half
+	{
+		seed_matcher seed(first, seed_edits);
+		verifier whole(query, max_edits);
+		auto found = [&](const text& key, const typename trie::node_type& node, integer edits){
+			results.emplace_back(key, node.value(), edits);
+		};
+		traverse(T.root(), seed, seed.matched(), whole, current, found);
+	}
+	std::size_t forward = results.size();
+	std::sort(results.begin(), results.end(), by_key);
+
+	// keys with a suffix close to the second half, unless already found
+	{
+		seed_matcher seed(second, seed_edits);
+		verifier whole(reversed_query, max_edits);
+		text key;
+		auto found = [&](const text& reversed_key, const typename reversed_trie::node_type& node, integer edits){
+			key.assign(reversed_key.rbegin(), reversed_key.rend());
+			auto p = std::lower_bound(results.begin(), results.begin() + forward, key,
+				[](const auto& r, const text& k){ return std::get<0>(r) < k; });
+			if(p != results.begin() + forward && std::get<0>(*p) == key)
+				return;
+			results.emplace_back(key, node.value(), edits);
+		};
+		traverse(R.root(), seed, seed.matched(), whole, current, found);
+	}
+	std::sort(results.begin() + forward, results.end(), by_key);
+	std::inplace_merge(results.begin(), results.begin() + forward, results.end(), by_key);
+
+	for(auto& [key, value, edits]: results)
+		*bi++ = {std::move(key), value, edits};
+}
+
+template<class trie, class seed_matcher, class verifier>
+template<class node_type, class callback>
+void partition_search_client<trie, seed_matcher, verifier>::traverse(node_type node, seed_matcher& seed, bool seeded,
+	verifier& whole, text& current, callback& found)
+{
+	if(node.match() && whole.matched())
+		found(current, node, static_cast<integer>(whole.distance()));
+	if(node.leaf())
+		return;
+	for(const auto& n: node.children()){
+		if(!seeded && !seed.update(n.label()))
+			continue;
+		if(whole.update(n.label())){
+			current.push_back(n.label());
+			traverse(n, seed, seeded || seed.matched(), whole, current, found);
+			current.pop_back();
+			whole.back();
+		}
+		if(!seeded)
+			seed.back();
+	}
+}
+
+}
+
+#endif
@@ -29,7 +29,7 @@ namespace trimatch{
 template<typename stream_type>
 concept readable = requires(stream_type& s, char buf[1])
 {
-	s.read(&buf, 1);
+	s.read(buf, 1);
 };
 
 }
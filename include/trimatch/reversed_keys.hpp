@@ -0,0 +1,154 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Trie of the reversed keys of a trie and their values, for suffix search
+*/
+
+#ifndef TRIMATCH_REVERSED_KEYS
+#define TRIMATCH_REVERSED_KEYS
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <algorithm>
+
+#include <sftrie/util.hpp>
+
+#include "trie_selector.hpp"
+#include "subtree_counts.hpp"
+#include "readable.hpp"
+
+namespace trimatch{
+
+// value is the value_type of the trie of keys
+template<typename text, typename value = bool, typename integer = std::uint32_t>
+class reversed_keys
+{
+public:
+	// values are copied, so that results need not be looked up in the trie of keys
+	using trie_type = typename trie_selector<value>::template trie_type<text, integer>;
+
+	template<class forward_trie>
+	void build(const forward_trie& T);
+	void clear();
+
+	bool empty() const;
+	// keys of T reversed, with their values in T
+	const trie_type& trie() const;
+	// number of keys in each subtree of trie()
+	const subtree_counts<integer>& counts() const;
+
+	std::size_t space() const;
+
+	template<typename output_stream>
+	void save(output_stream& os) const;
+	template<readable input_stream>
+	void load(input_stream& is);
+
+private:
+	std::optional<trie_type> R;
+	subtree_counts<integer> subtree_sizes;
+
+	template<class node_type>
+	static void collect(node_type node, text& current, std::vector<std::pair<text, value>>& keys);
+};
+
+template<typename text, typename value, typename integer>
+template<class forward_trie>
+void reversed_keys<text, value, integer>::build(const forward_trie& T)
+{
+	std::vector<std::pair<text, value>> keys;
+	text current;
+	collect(T.root(), current, keys);
+	for(auto& key: keys)
+		std::reverse(key.first.begin(), key.first.end());
+	sftrie::sort_text_item_pairs(keys.begin(), keys.end());
+	R.emplace(keys.begin(), keys.end());
+	subtree_sizes.build(*R);
+}
+
+template<typename text, typename value, typename integer>
+template<class node_type>
+void reversed_keys<text, value, integer>::collect(node_type node, text& current, std::vector<std::pair<text, value>>& keys)
+{
+	if(node.match())
+		keys.emplace_back(current, node.value());
+	if(node.leaf())
+		return;
+	for(const auto& n: node.children()){
+		current.push_back(n.label());
+		collect(n, current, keys);
+		current.pop_back();
+	}
+}
+
+template<typename text, typename value, typename integer>
+void reversed_keys<text, value, integer>::clear()
+{
+	R.reset();
+	subtree_sizes.clear();
+}
+
+template<typename text, typename value, typename integer>
+inline bool reversed_keys<text, value, integer>::empty() const
+{
+	return !R;
+}
+
+template<typename text, typename value, typename integer>
+inline const typename reversed_keys<text, value, integer>::trie_type& reversed_keys<text, value, integer>::trie() const
+{
+	return *R;
+}
+
+template<typename text, typename value, typename integer>
+inline const subtree_counts<integer>& reversed_keys<text, value, integer>::counts() const
+{
+	return subtree_sizes;
+}
+
+template<typename text, typename value, typename integer>
+std::size_t reversed_keys<text, value, integer>::space() const
+{
+	return R ? R->total_space() + subtree_sizes.space() : 0;
+}
+
+// the counts are not saved but rebuilt on load
+template<typename text, typename value, typename integer>
+template<typename output_stream>
+void reversed_keys<text, value, integer>::save(output_stream& os) const
+{
+	R->save(os);
+}
+
+template<typename text, typename value, typename integer>
+template<readable input_stream>
+void reversed_keys<text, value, integer>::load(input_stream& is)
+{
+	R.emplace();
+	R->load(is);
+	subtree_sizes.build(*R);
+}
+
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Scores of keys and maximum score in each subtree of a trie
+*/
+
+#ifndef TRIMATCH_SCORE_BOUNDS
+#define TRIMATCH_SCORE_BOUNDS
+
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+
+#include "node_annotation.hpp"
+
+namespace trimatch{
+
+template<typename score_type = double>
+class score_bounds: public node_annotation<score_type, 2>
+{
+public:
+	// score(value) is computed once for each key
+	template<class trie, class projection>
+	void build(const trie& T, projection score);
+
+	// score of the key at node id
+	score_type score(std::size_t id) const;
+	// maximum score of keys below node id; lowest() if there is no key
+	score_type max(std::size_t id) const;
+
+private:
+	static constexpr std::size_t scores = 0;
+	static constexpr std::size_t upper = 1;
+
+	template<class node_type, class projection>
+	void annotate(node_type node, projection& score);
+};
+
+template<typename score_type>
+template<class trie, class projection>
+void score_bounds<score_type>::build(const trie& T, projection score)
+{
+	this->data[scores].assign(T.node_size(), std::numeric_limits<score_type>::lowest());
+	this->data[upper].assign(T.node_size(), std::numeric_limits<score_type>::lowest());
+	annotate(T.root(), score);
+}
+
+template<typename score_type>
+template<class node_type, class projection>
+void score_bounds<score_type>::annotate(node_type node, projection& score)
+{
+	auto& own = this->data[scores];
+	auto& highest = this->data[upper];
+	auto id = node.id();
+	if(node.match()){
+		own[id] = static_cast<score_type>(score(node.value()));
+		highest[id] = own[id];
+	}
+	if(node.leaf())
+		return;
+	for(const auto& n: node.children()){
+		annotate(n, score);
+		highest[id] = std::max(highest[id], highest[n.id()]);
+	}
+}
+
+template<typename score_type>
+inline score_type score_bounds<score_type>::score(std::size_t id) const
+{
+	return this->data[scores][id];
+}
+
+template<typename score_type>
+inline score_type score_bounds<score_type>::max(std::size_t id) const
+{
+	return this->data[upper][id];
+}
+
+}
+
+#endif
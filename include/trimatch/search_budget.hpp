@@ -0,0 +1,120 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Limits on the work of a single search
+*/
+
+#ifndef TRIMATCH_SEARCH_BUDGET
+#define TRIMATCH_SEARCH_BUDGET
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <chrono>
+
+namespace trimatch{
+
+struct search_budget
+{
+	// trie nodes examined
+	std::size_t max_nodes = std::numeric_limits<std::size_t>::max();
+	std::size_t max_results = std::numeric_limits<std::size_t>::max();
+	std::optional<std::chrono::steady_clock::time_point> deadline;
+	// the clock is read once every check_interval nodes; 0 is treated as 1
+	std::size_t check_interval = 1024;
+};
+
+struct search_status
+{
+	std::size_t nodes = 0;
+	std::size_t results = 0;
+	// stopped by the budget; more results may exist
+	bool truncated = false;
+};
+
+// counts the work of a search against a budget
+class budget_meter
+{
+public:
+	budget_meter(const search_budget& budget);
+
+	// called before examining a node; false if the budget is exhausted
+	bool enter();
+	// called before reporting a result; false if max_results have been reported
+	bool emit();
+
+	const search_status& status() const;
+
+private:
+	const search_budget& budget;
+	search_status current;
+};
+
+// no limits; checks are optimized away
+struct unlimited_meter
+{
+	static constexpr bool enter()
+	{
+		return true;
+	}
+
+	static constexpr bool emit()
+	{
+		return true;
+	}
+};
+
+inline budget_meter::budget_meter(const search_budget& budget):
+	budget(budget)
+{}
+
+inline bool budget_meter::enter()
+{
+	if(current.nodes == budget.max_nodes){
+		current.truncated = true;
+		return false;
+	}
+	++current.nodes;
+	if(budget.deadline && (budget.check_interval <= 1 || current.nodes % budget.check_interval == 0) &&
+			std::chrono::steady_clock::now() >= *budget.deadline){
+		current.truncated = true;
+		return false;
+	}
+	return true;
+}
+
+inline bool budget_meter::emit()
+{
+	if(current.results == budget.max_results){
+		current.truncated = true;
+		return false;
+	}
+	++current.results;
+	return true;
+}
+
+inline const search_status& budget_meter::status() const
+{
+	return current;
+}
+
+}
+
+#endif
@@ -23,12 +23,57 @@ Main interface for search operations
 #ifndef TRIMATCH_SEARCH_CLIENT
 #define TRIMATCH_SEARCH_CLIENT
 
+#include <cstddef>
+#include <vector>
+#include <string>
+#include <memory>
+#include <optional>
+#include <functional>
+#include <limits>
+#include <algorithm>
+#include <queue>
+#include <tuple>
+#include <stdexcept>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <string_view>
+#include <concepts>
+#include <iterator>
+
 #include <sftrie/util.hpp>
 
 #include "levenshtein_dfa.hpp"
+#include "automaton_cache.hpp"
+#include "length_bounds.hpp"
+#include "score_bounds.hpp"
+#include "subtree_counts.hpp"
+#include "reversed_keys.hpp"
+#include "autocomplete_session.hpp"
+#include "search_budget.hpp"
+#include "find_node.hpp"
+#include "parallel_executor.hpp"
 
 namespace trimatch{
 
+// matchers which can start over with another pattern without being reconstructed
+template<typename matcher, typename text, typename integer>
+concept resettable_matcher = requires(matcher& m, const text& pattern, integer max_edits)
+{
+	m.reset(pattern, max_edits);
+};
+
+// order of results of approximate predictive search
+enum class predict_order
+{
+	// depth-first order of the trie
+	trie,
+	// ascending length of keys
+	shortest_first,
+	// ascending edits for whole keys
+	fewest_edits_first,
+};
+
 template<
 	class trie,
 	class approximate_matcher = LevenshteinDFA<typename trie::text_type, typename trie::integer_type>
@@ -41,8 +86,11 @@ private:
 
 public:
 	using value_type = typename trie::value_type;
+	using node_type = typename trie::node_type;
+	using key_view = std::basic_string_view<typename text::value_type>;
 	using prefix_search_iterator = typename trie::prefix_iterator;
 	using predictive_search_iterator = typename trie::subtree_iterator;
+	using cache_type = automaton_cache<text, integer, approximate_matcher>;
 
 	// matched text, associated value, edits
 	struct approximate_search_result;
@@ -51,7 +99,21 @@ public:
 
 	struct approximate_search_iterator;
 
-	search_client(const trie& T);
+	// subtrees are skipped by key length if bounds are given; predict_topk() requires scores;
+	// predict_count() reads counts if given; suffix search requires reversed keys
+	search_client(const trie& T, const length_bounds<integer>* bounds = nullptr, const score_bounds<>* scores = nullptr,
+		const subtree_counts<integer>* counts = nullptr, const reversed_keys<text, value_type, integer>* reversed = nullptr);
+
+	// reuse compiled automata of recent (query, max_edits) pairs; copies of this searcher share the cache
+	void enable_cache(std::size_t capacity) requires compilable_matcher<approximate_matcher, text, integer>;
+	void disable_cache();
+	const std::shared_ptr<cache_type>& cache() const;
+
+	// reuse one matcher and key buffer across approx(), approx_predict() and their variants other than
+	// suffix search instead of constructing them per query; a searcher with reuse enabled must not be shared by threads,
+	// and searches started from a visitor during another search construct their own matcher
+	void enable_matcher_reuse() requires resettable_matcher<approximate_matcher, text, integer>;
+	void disable_matcher_reuse();
 
 	// exact match
 	bool exact(const text& query) const;
@@ -63,30 +125,168 @@ public:
 	predictive_search_iterator predict(const text& query);
 	template<class back_insert_iterator>
 	void predict(const text& query, back_insert_iterator bi);
+	// counts nodes below the query only
+	template<class back_insert_iterator>
+	search_status predict(const text& query, const search_budget& budget, back_insert_iterator bi) const;
+	// number of results of predictive search
+	std::size_t predict_count(const text& query) const;
+	// at most k completions of the highest scores in descending order, as (text, value, score);
+	// subtrees whose maximum score cannot enter the results are not visited
+	template<class back_insert_iterator>
+	void predict_topk(const text& query, std::size_t k, back_insert_iterator bi) const;
 
 	// approximate search
 	approximate_search_iterator approx(const text& query, integer max_edits = 1) const;
 	template<class back_insert_iterator>
 	void approx(const text& query, integer max_edits, back_insert_iterator bi) const;
+	// calls visitor(key, node, edits) for each result without copying keys or values;
+	// key refers to the traversal buffer and is valid only during the call
+	template<class visitor>
+		requires std::invocable<visitor&, key_view, node_type, integer>
+	void approx(const text& query, integer max_edits, visitor visit) const;
+	// stops when the budget runs out, keeping the results found so far
+	template<class back_insert_iterator>
+	search_status approx(const text& query, integer max_edits, const search_budget& budget, back_insert_iterator bi) const;
+	// number of results of approximate search
+	std::size_t approx_count(const text& query, integer max_edits) const;
+
+	// approximate search split into subtrees below the root searched by threads (0: hardware concurrency);
+	// results are in the same order as approx(); an exception in any thread is rethrown after all have stopped
+	template<class back_insert_iterator>
+	void approx_parallel(const text& query, integer max_edits, std::size_t threads, back_insert_iterator bi) const;
+	// same, with the threads of run, e.g. a pool shared by searches
+	template<parallel_executor executor, class back_insert_iterator>
+	void approx_parallel(const text& query, integer max_edits, executor& run, back_insert_iterator bi) const;
+
+	// at most k results of approximate search in ascending order of edits, explored best-first;
+	// ties are broken in an unspecified order
+	template<class back_insert_iterator>
+	void approx_topk(const text& query, std::size_t k, integer max_edits, back_insert_iterator bi) const;
+
+	// approximate search with radius 0, 1, ... up to max_cap, stopping at the first radius with at least
+	// min_results results; results are in ascending order of edits and the effective radius is returned;
+	// each radius continues the traversal of the smaller ones instead of starting over
+	template<class back_insert_iterator>
+	integer approx_adaptive(const text& query, std::size_t min_results, integer max_cap, back_insert_iterator bi) const;
+
+	// approximate search for many queries in a single traversal;
+	// results are (query index, matched text, associated value, edits)
+	template<class back_insert_iterator>
+	void approx_batch(const std::vector<text>& queries, integer max_edits, back_insert_iterator bi) const;
 
 	// approximate predictive search
 	template<class back_insert_iterator>
 	void approx_predict(const text& query, integer max_edits, back_insert_iterator bi) const;
+	template<class back_insert_iterator>
+	search_status approx_predict(const text& query, integer max_edits, const search_budget& budget, back_insert_iterator bi) const;
+	// at most max_results results in the given order; ties are kept in the order of the trie
+	template<class back_insert_iterator>
+	void approx_predict(const text& query, integer max_edits, std::size_t max_results, predict_order order,
+		back_insert_iterator bi) const;
+
+	// approximate predictive search updated symbol by symbol as a query is typed
+	autocomplete_session<trie> session(integer max_edits) const;
+
+	// keys ending with the query
+	template<class back_insert_iterator>
+	void suffix(const text& query, back_insert_iterator bi) const;
+	// keys with a suffix within max_edits of the query, as (key, value, edits (suffix), edits (whole key));
+	// in the order of the reversed keys
+	template<class back_insert_iterator>
+	void approx_suffix(const text& query, integer max_edits, back_insert_iterator bi) const;
+	// same results as approx(), searched from the end of the query if keys ending with its last
+	// max_edits + 1 symbols are fewer than keys starting with its first ones, and then in the order
+	// of the reversed keys; requires subtree counts to compare them without traversal
+	template<class back_insert_iterator>
+	void approx_bidirectional(const text& query, integer max_edits, back_insert_iterator bi) const;
 
 private:
+	// lengths of keys which can match a query
+	struct length_range
+	{
+		std::size_t min;
+		std::size_t max;
+	};
+
 	const trie& T;
 	typename trie::common_searcher trie_search_client;
+	std::shared_ptr<cache_type> automata;
+	const length_bounds<integer>* bounds;
+	const score_bounds<>* scores;
+	const subtree_counts<integer>* counts;
+	const reversed_keys<text, value_type, integer>* reversed;
+
+	// searcher of the reversed keys, shared by copies of this searcher; it constructs a matcher for each query
+	using reversed_searcher_type = search_client<typename reversed_keys<text, value_type, integer>::trie_type, approximate_matcher>;
+	std::shared_ptr<const reversed_searcher_type> reversed_client;
+
+	// reused by approx() and approx_predict() if enabled; busy while a search uses them
+	bool reuse;
+	mutable bool scratch_busy;
+	mutable std::optional<approximate_matcher> scratch;
+	mutable text scratch_text;
+
+	struct scratch_guard
+	{
+		bool& busy;
+
+		scratch_guard(bool& busy): busy(busy)
+		{
+			busy = true;
+		}
+
+		~scratch_guard()
+		{
+			busy = false;
+		}
+	};
+
+	approximate_matcher make_matcher(const text& query, integer max_edits) const;
+	approximate_matcher& reuse_matcher(const text& query, integer max_edits) const
+		requires resettable_matcher<approximate_matcher, text, integer>;
 
+	static length_range match_lengths(const text& query, integer max_edits, bool predictive);
+	static integer min_distance(const approximate_matcher& matcher);
+
+	// best-first approximate search stopping at limit results, or after the radius where they are reached
 	template<class back_insert_iterator>
-	void approx_step(approximate_matcher& matcher,
-		typename trie::node_type root, text& current, back_insert_iterator& bi) const;
+	integer approx_ranked(const text& query, integer max_edits, std::size_t limit, bool whole_radius,
+		back_insert_iterator& bi) const;
+	bool reachable(typename trie::node_type node, const length_range& lengths) const;
+
+	const reversed_searcher_type& reversed_searcher(const char* caller) const;
+	static std::size_t count_keys(typename trie::node_type root);
 
+	// steps return false when the meter stops the search
+	template<class visitor, class meter>
+	void approx_visit(const text& query, integer max_edits, visitor& visit, meter& m) const;
+	template<class visitor, class meter>
+	bool approx_step(approximate_matcher& matcher, const length_range& lengths,
+		typename trie::node_type root, text& current, visitor& visit, meter& m) const;
 	template<class back_insert_iterator>
-	void approx_predict_step(integer max_edits, approximate_matcher& matcher,
-		typename trie::node_type root, text& current, back_insert_iterator& bi) const;
+	bool predict_step(typename trie::node_type root, text& current, budget_meter& m, back_insert_iterator& bi) const;
+
+	// results of nodes above the split depth, or a subtree to be searched with a copy of the matcher
+	struct approx_task
+	{
+		std::vector<approximate_search_result> results;
+		std::optional<typename trie::node_type> root;
+		text current;
+		std::optional<approximate_matcher> matcher;
+	};
+	std::size_t split(approximate_matcher& matcher, const length_range& lengths, typename trie::node_type root,
+		text& current, std::size_t depth, std::vector<approx_task>& tasks) const;
+
 	template<class back_insert_iterator>
-	void correct_approx_predict_results(integer max_edits, approximate_matcher& matcher,
-		typename trie::node_type root, text& current, integer prefix_edits, integer current_edits, back_insert_iterator& bi) const;
+	void approx_batch_step(std::vector<approximate_matcher>& matchers, const std::vector<length_range>& lengths,
+		std::vector<std::size_t>& alive, std::size_t first, typename trie::node_type root, text& current, back_insert_iterator& bi) const;
+
+	template<class meter, class back_insert_iterator>
+	void approx_predict_run(const text& query, integer max_edits, std::size_t max_results, predict_order order,
+		meter& m, back_insert_iterator& bi) const;
+	template<class meter, class back_insert_iterator>
+	void approx_predict_traverse(integer max_edits, approximate_matcher& matcher, const length_range& lengths,
+		text& current, std::size_t max_results, predict_order order, meter& m, back_insert_iterator& bi) const;
 };
 
 
@@ -110,18 +310,31 @@ struct search_client<trie, approximate_matcher>::approximate_predictive_search_r
 template<class trie, class approximate_matcher>
 struct search_client<trie, approximate_matcher>::approximate_search_iterator
 {
-	const trie &T;
+	using value_type = approximate_search_result;
+	using difference_type = std::ptrdiff_t;
+	using iterator_concept = std::input_iterator_tag;
 
-	const text& query;
-	const integer max_edits;
+	// owned, so that iterators made from temporaries remain valid
+	text query;
+	integer max_edits;
 
 	approximate_matcher matcher;
 
+	// subtrees are skipped by key length if bounds are given
+	const length_bounds<integer>* bounds;
+	length_range lengths;
+
 	std::vector<typename trie::child_iterator> path;
 	text current;
 
 	approximate_search_iterator(const trie& T, const text& query, integer max_edits):
-		T(T), query(query), max_edits(max_edits), matcher(query, max_edits)
+		approximate_search_iterator(T, query, max_edits, approximate_matcher(query, max_edits))
+	{}
+
+	approximate_search_iterator(const trie& T, const text& query, integer max_edits, approximate_matcher&& matcher,
+		const length_bounds<integer>* bounds = nullptr):
+		query(query), max_edits(max_edits), matcher(std::move(matcher)),
+		bounds(bounds), lengths(match_lengths(query, max_edits, false))
 	{
 		if(!query.empty()){
 			path.push_back(typename trie::child_iterator(T));
@@ -134,14 +347,21 @@ struct search_client<trie, approximate_matcher>::approximate_search_iterator
 		return *this;
 	}
 
-	approximate_search_iterator end()
+	// the search is over when the path is empty
+	std::default_sentinel_t end() const
 	{
-		return approximate_search_iterator(T, text(), 0);
+		return std::default_sentinel;
 	}
 
-	bool operator!=(const approximate_search_iterator& i) const
+	bool operator==(std::default_sentinel_t) const
 	{
-		return path != i.path;
+		return path.empty();
+	}
+
+	// matched text on the current path, valid until the iterator is advanced
+	key_view key() const
+	{
+		return key_view(current.data(), current.size());
 	}
 
 	approximate_search_result operator*() const
@@ -159,7 +379,9 @@ struct search_client<trie, approximate_matcher>::approximate_search_iterator
 	bool try_transition(const typename trie::child_iterator& next)
 	{
 		auto c = (*next).label();
-		auto result = matcher.update(c);
+		auto id = (*next).id();
+		auto result = (bounds == nullptr || (bounds->min(id) <= lengths.max && bounds->max(id) >= lengths.min)) &&
+			matcher.update(c);
 		path.push_back(next);
 		current.push_back(c);
 
@@ -203,13 +425,125 @@ struct search_client<trie, approximate_matcher>::approximate_search_iterator
 
 		return *this;
 	}
+
+	void operator++(int)
+	{
+		++*this;
+	}
 };
 
 
 template<class trie, class approximate_matcher>
-search_client<trie, approximate_matcher>::search_client(const trie& T):
-	T(T), trie_search_client(T.searcher())
-{}
+search_client<trie, approximate_matcher>::search_client(
+	const trie& T, const length_bounds<integer>* bounds, const score_bounds<>* scores,
+	const subtree_counts<integer>* counts, const reversed_keys<text, value_type, integer>* reversed
+):
+	T(T), trie_search_client(T.searcher()), bounds(bounds), scores(scores), counts(counts), reversed(reversed),
+	reuse(false), scratch_busy(false)
+{
+	if(reversed != nullptr)
+		reversed_client = std::make_shared<const reversed_searcher_type>(reversed->trie(), nullptr, nullptr, &reversed->counts());
+}
+
+template<class trie, class approximate_matcher>
+void search_client<trie, approximate_matcher>::enable_cache(std::size_t capacity)
+	requires compilable_matcher<approximate_matcher, text, integer>
+{
+	automata = std::make_shared<cache_type>(capacity);
+}
+
+template<class trie, class approximate_matcher>
+void search_client<trie, approximate_matcher>::disable_cache()
+{
+	automata.reset();
+}
+
+template<class trie, class approximate_matcher>
+const std::shared_ptr<typename search_client<trie, approximate_matcher>::cache_type>&
+search_client<trie, approximate_matcher>::cache() const
+{
+	return automata;
+}
+
+template<class trie, class approximate_matcher>
+void search_client<trie, approximate_matcher>::enable_matcher_reuse()
+	requires resettable_matcher<approximate_matcher, text, integer>
+{
+	reuse = true;
+}
+
+template<class trie, class approximate_matcher>
+void search_client<trie, approximate_matcher>::disable_matcher_reuse()
+{
+	reuse = false;
+	scratch.reset();
+	scratch_text = text();
+}
+
+template<class trie, class approximate_matcher>
+approximate_matcher search_client<trie, approximate_matcher>::make_matcher(const text& query, integer max_edits) const
+{
+	if constexpr(compilable_matcher<approximate_matcher, text, integer>){
+		if(automata)
+			return approximate_matcher(automata->get(query, max_edits));
+	}
+	return approximate_matcher(query, max_edits);
+}
+
+template<class trie, class approximate_matcher>
+approximate_matcher& search_client<trie, approximate_matcher>::reuse_matcher(const text& query, integer max_edits) const
+	requires resettable_matcher<approximate_matcher, text, integer>
+{
+	if(!scratch){
+		scratch.emplace(make_matcher(query, max_edits));
+		return *scratch;
+	}
+	if constexpr(compilable_matcher<approximate_matcher, text, integer>){
+		if constexpr(requires{ scratch->reset(automata->get(query, max_edits)); }){
+			if(automata){
+				scratch->reset(automata->get(query, max_edits));
+				return *scratch;
+			}
+		}
+	}
+	scratch->reset(query, max_edits);
+	return *scratch;
+}
+
+// a key of length l is within max_edits of the query only if |l - query.size()| <= max_edits;
+// predictive search also accepts longer keys
+template<class trie, class approximate_matcher>
+typename search_client<trie, approximate_matcher>::length_range
+search_client<trie, approximate_matcher>::match_lengths(const text& query, integer max_edits, bool predictive)
+{
+	// matchers may consume several symbols per edit, e.g. bytes of a code point
+	std::size_t slack = max_edits;
+	if constexpr(requires{ approximate_matcher::symbols_per_edit; })
+		slack *= approximate_matcher::symbols_per_edit;
+	return {
+		query.size() > slack ? query.size() - slack : 0,
+		predictive ? std::numeric_limits<std::size_t>::max() : query.size() + slack
+	};
+}
+
+template<class trie, class approximate_matcher>
+inline bool search_client<trie, approximate_matcher>::reachable(
+	typename trie::node_type node, const length_range& lengths) const
+{
+	return bounds == nullptr ||
+		(bounds->min(node.id()) <= lengths.max && bounds->max(node.id()) >= lengths.min);
+}
+
+// edits of any continuation are at least this
+template<class trie, class approximate_matcher>
+inline typename search_client<trie, approximate_matcher>::integer
+search_client<trie, approximate_matcher>::min_distance(const approximate_matcher& matcher)
+{
+	if constexpr(requires{ matcher.min_distance(); })
+		return static_cast<integer>(matcher.min_distance());
+	else
+		return matcher.matched() ? 0 : static_cast<integer>(matcher.distance());
+}
 
 template<class trie, class approximate_matcher>
 bool search_client<trie, approximate_matcher>::exact(const text& query) const
@@ -240,11 +574,133 @@ void search_client<trie, approximate_matcher>::predict(
 		*bi++ = r.key();
 }
 
+template<class trie, class approximate_matcher>
+template<class back_insert_iterator>
+search_status search_client<trie, approximate_matcher>::predict(
+	const text& query, const search_budget& budget, back_insert_iterator bi) const
+{
+	budget_meter m(budget);
+	auto node = find_node(T, query);
+	if(!node)
+		return m.status();
+
+	text current = query;
+	predict_step(*node, current, m, bi);
+	return m.status();
+}
+
+template<class trie, class approximate_matcher>
+std::size_t search_client<trie, approximate_matcher>::predict_count(const text& query) const
+{
+	auto node = find_node(T, query);
+	if(!node)
+		return 0;
+	return counts != nullptr ? counts->count(node->id()) : count_keys(*node);
+}
+
+template<class trie, class approximate_matcher>
+std::size_t search_client<trie, approximate_matcher>::count_keys(typename trie::node_type root)
+{
+	std::size_t n = root.match() ? 1 : 0;
+	if(!root.leaf())
+		for(const auto& c: root.children())
+			n += count_keys(c);
+	return n;
+}
+
+template<class trie, class approximate_matcher>
+template<class back_insert_iterator>
+bool search_client<trie, approximate_matcher>::predict_step(
+	typename trie::node_type root, text& current, budget_meter& m, back_insert_iterator& bi) const
+{
+	if(root.match()){
+		if(!m.emit())
+			return false;
+		*bi++ = current;
+	}
+	if(root.leaf())
+		return true;
+	for(const auto& n: root.children()){
+		if(!m.enter())
+			return false;
+		current.push_back(n.label());
+		bool more = predict_step(n, current, m, bi);
+		current.pop_back();
+		if(!more)
+			return false;
+	}
+	return true;
+}
+
+template<class trie, class approximate_matcher>
+template<class back_insert_iterator>
+void search_client<trie, approximate_matcher>::predict_topk(
+	const text& query, std::size_t k, back_insert_iterator bi) const
+{
+	if(scores == nullptr)
+		throw std::logic_error("predict_topk requires score bounds");
+	if(k == 0)
+		return;
+
+	// reached nodes; index 0 is the root
+	struct entry
+	{
+		typename trie::node_type node;
+		std::size_t parent;
+	};
+	std::vector<entry> entries = {{T.root(), 0}};
+	for(const auto c: query){
+		std::size_t e = entries.size() - 1;
+		if(!entries[e].node.leaf()){
+			for(const auto& n: entries[e].node.children()){
+				if(n.label() == c){
+					entries.push_back({n, e});
+					break;
+				}
+			}
+		}
+		if(entries.size() == e + 1)
+			return;
+	}
+
+	// (score, whether it is a result, entry); results go first among equal scores,
+	// so a popped result is never outscored by anything left
+	std::priority_queue<std::tuple<double, bool, std::size_t>> queue;
+	queue.emplace(scores->max(entries.back().node.id()), false, entries.size() - 1);
+
+	text key;
+	std::size_t found = 0;
+	while(!queue.empty()){
+		auto [score, result, e] = queue.top();
+		queue.pop();
+		auto node = entries[e].node;
+		if(result){
+			key.clear();
+			for(std::size_t i = e; i != 0; i = entries[i].parent)
+				key.push_back(entries[i].node.label());
+			std::reverse(key.begin(), key.end());
+			*bi++ = {key, node.value(), score};
+			if(++found == k)
+				return;
+			continue;
+		}
+
+		if(node.match())
+			queue.emplace(scores->score(node.id()), true, e);
+		if(node.leaf())
+			continue;
+		for(const auto& n: node.children()){
+			queue.emplace(scores->max(n.id()), false, entries.size());
+			entries.push_back({n, e});
+		}
+	}
+}
+
 template<class trie, class approximate_matcher>
 typename search_client<trie, approximate_matcher>::approximate_search_iterator
 search_client<trie, approximate_matcher>::approx(const text& query, integer max_edits) const
 {
-	return approximate_search_iterator(T, query, max_edits);
+	return approximate_search_iterator(T, query, max_edits, make_matcher(query, max_edits), bounds);
 }
 
 template<class trie, class approximate_matcher>
@@ -252,82 +708,571 @@ template<class back_insert_iterator>
 void search_client<trie, approximate_matcher>::approx(
 	const text& query, integer max_edits, back_insert_iterator bi) const
 {
-	approximate_matcher matcher(query, max_edits);
-	text current;
-	approx_step(matcher, T.root(), current, bi);
+	approx(query, max_edits, [&](key_view key, node_type node, integer edits){
+		*bi++ = {text(key.begin(), key.end()), node.value(), edits};
+	});
+}
+
+template<class trie, class approximate_matcher>
+template<class visitor>
+	requires std::invocable<visitor&, typename search_client<trie, approximate_matcher>::key_view,
+		typename trie::node_type, typename trie::integer_type>
+void search_client<trie, approximate_matcher>::approx(
+	const text& query, integer max_edits, visitor visit) const
+{
+	unlimited_meter m;
+	approx_visit(query, max_edits, visit, m);
 }
 
 template<class trie, class approximate_matcher>
 template<class back_insert_iterator>
-void search_client<trie, approximate_matcher>::approx_step(
-	approximate_matcher& matcher, typename trie::node_type root, text& current, back_insert_iterator& bi) const
+search_status search_client<trie, approximate_matcher>::approx(
+	const text& query, integer max_edits, const search_budget& budget, back_insert_iterator bi) const
+{
+	budget_meter m(budget);
+	auto visit = [&](key_view key, node_type node, integer edits){
+		*bi++ = {text(key.begin(), key.end()), node.value(), edits};
+	};
+	approx_visit(query, max_edits, visit, m);
+	return m.status();
+}
+
+template<class trie, class approximate_matcher>
+std::size_t search_client<trie, approximate_matcher>::approx_count(const text& query, integer max_edits) const
+{
+	std::size_t n = 0;
+	approx(query, max_edits, [&](key_view, node_type, integer){
+		++n;
+	});
+	return n;
+}
+
+template<class trie, class approximate_matcher>
+template<class visitor, class meter>
+void search_client<trie, approximate_matcher>::approx_visit(
+	const text& query, integer max_edits, visitor& visit, meter& m) const
 {
-	if(root.match() && matcher.matched())
-		*bi++ = {current, root.value(), static_cast<integer>(matcher.distance())};
+	auto lengths = match_lengths(query, max_edits, false);
+	if constexpr(resettable_matcher<approximate_matcher, text, integer>){
+		if(reuse && !scratch_busy){
+			scratch_guard guard(scratch_busy);
+			scratch_text.clear();
+			approx_step(reuse_matcher(query, max_edits), lengths, T.root(), scratch_text, visit, m);
+			return;
+		}
+	}
+	auto matcher = make_matcher(query, max_edits);
+	text current;
+	approx_step(matcher, lengths, T.root(), current, visit, m);
+}
+
+template<class trie, class approximate_matcher>
+template<class visitor, class meter>
+bool search_client<trie, approximate_matcher>::approx_step(approximate_matcher& matcher,
+	const length_range& lengths, typename trie::node_type root, text& current, visitor& visit, meter& m) const
+{
+	if(root.match() && matcher.matched()){
+		if(!m.emit())
+			return false;
+		visit(key_view(current.data(), current.size()), root, static_cast<integer>(matcher.distance()));
+	}
 	if(root.leaf())
-		return;
+		return true;
 	for(const auto& n: root.children()){
-		if(matcher.update(n.label())){
+		if(!m.enter())
+			return false;
+		if(reachable(n, lengths) && matcher.update(n.label())){
 			current.push_back(n.label());
-			approx_step(matcher, n, current, bi);
+			bool more = approx_step(matcher, lengths, n, current, visit, m);
 			current.pop_back();
 			matcher.back();
+			if(!more)
+				return false;
 		}
 	}
+	return true;
 }
 
 template<class trie, class approximate_matcher>
 template<class back_insert_iterator>
-void search_client<trie, approximate_matcher>::approx_predict(
-	const text& query, integer max_edits, back_insert_iterator bi) const
+void search_client<trie, approximate_matcher>::approx_parallel(
+	const text& query, integer max_edits, std::size_t threads, back_insert_iterator bi) const
+{
+	thread_executor run(threads);
+	approx_parallel(query, max_edits, run, bi);
+}
+
+template<class trie, class approximate_matcher>
+template<parallel_executor executor, class back_insert_iterator>
+void search_client<trie, approximate_matcher>::approx_parallel(
+	const text& query, integer max_edits, executor& run, back_insert_iterator bi) const
 {
-	approximate_matcher matcher(query, max_edits);
+	std::size_t threads = std::max<std::size_t>(run.concurrency(), 1);
+	auto matcher = make_matcher(query, max_edits);
+	auto lengths = match_lengths(query, max_edits, false);
+
+	// split deeper until there are enough subtrees to balance the load
+	std::vector<approx_task> tasks;
 	text current;
-	approx_predict_step(max_edits, matcher, T.root(), current, bi);
+	std::size_t subtrees = 0;
+	for(std::size_t depth = 1; ; ++depth){
+		tasks.clear();
+		subtrees = split(matcher, lengths, T.root(), current, depth, tasks);
+		if(subtrees == 0 || subtrees >= 4 * threads || depth >= lengths.max)
+			break;
+	}
+
+	// subtrees are taken in order by whichever thread is free; the first exception stops the others
+	std::atomic<std::size_t> next = 0;
+	std::exception_ptr error;
+	std::mutex error_lock;
+	std::function<void()> work = [&](){
+		try{
+			for(std::size_t i = next++; i < tasks.size(); i = next++){
+				auto& task = tasks[i];
+				if(task.root){
+					auto collect = [&](key_view key, node_type node, integer edits){
+						task.results.push_back({text(key.begin(), key.end()), node.value(), edits});
+					};
+					unlimited_meter m;
+					approx_step(*task.matcher, lengths, *task.root, task.current, collect, m);
+				}
+			}
+		}
+		catch(...){
+			std::lock_guard<std::mutex> lock(error_lock);
+			if(!error)
+				error = std::current_exception();
+			next = tasks.size();
+		}
+	};
+	// a single subtree is not worth waking other threads
+	if(threads == 1 || subtrees <= 1)
+		work();
+	else
+		run.run(work);
+	if(error)
+		std::rethrow_exception(error);
+
+	for(auto& task: tasks)
+		for(auto& r: task.results)
+			*bi++ = {std::move(r.key), r.value, r.edits};
+}
+
+template<class trie, class approximate_matcher>
+autocomplete_session<trie> search_client<trie, approximate_matcher>::session(integer max_edits) const
+{
+	return autocomplete_session<trie>(T, max_edits);
+}
+
+template<class trie, class approximate_matcher>
+const typename search_client<trie, approximate_matcher>::reversed_searcher_type&
+search_client<trie, approximate_matcher>::reversed_searcher(const char* caller) const
+{
+	if(reversed == nullptr)
+		throw std::logic_error(std::string(caller) + " requires reversed keys");
+	return *reversed_client;
+}
+
+template<class trie, class approximate_matcher>
+template<class back_insert_iterator>
+void search_client<trie, approximate_matcher>::suffix(const text& query, back_insert_iterator bi) const
+{
+	const auto& searcher = reversed_searcher("suffix");
+	std::vector<text> keys;
+	searcher.predict(text(query.rbegin(), query.rend()), search_budget{}, std::back_inserter(keys));
+	for(auto& key: keys){
+		std::reverse(key.begin(), key.end());
+		*bi++ = std::move(key);
+	}
 }
 
 template<class trie, class approximate_matcher>
 template<class back_insert_iterator>
-void search_client<trie, approximate_matcher>::approx_predict_step(
-	integer max_edits, approximate_matcher& matcher, typename trie::node_type root, text& current, back_insert_iterator& bi) const
+void search_client<trie, approximate_matcher>::approx_suffix(
+	const text& query, integer max_edits, back_insert_iterator bi) const
 {
-	if(matcher.matched()){
-		correct_approx_predict_results(max_edits, matcher, root, current, matcher.distance(), matcher.distance(), bi);
+	const auto& searcher = reversed_searcher("approx_suffix");
+	std::vector<typename reversed_searcher_type::approximate_predictive_search_result> results;
+	searcher.approx_predict(text(query.rbegin(), query.rend()), max_edits, std::back_inserter(results));
+	for(auto& r: results){
+		std::reverse(r.key.begin(), r.key.end());
+		*bi++ = {std::move(r.key), r.value, r.edits_prefix, r.edits_whole};
+	}
+}
+
+template<class trie, class approximate_matcher>
+template<class back_insert_iterator>
+void search_client<trie, approximate_matcher>::approx_bidirectional(
+	const text& query, integer max_edits, back_insert_iterator bi) const
+{
+	const auto& searcher = reversed_searcher("approx_bidirectional");
+	if(counts == nullptr)
+		throw std::logic_error("approx_bidirectional requires subtree counts");
+	std::size_t n = std::min<std::size_t>(query.size(), static_cast<std::size_t>(max_edits) + 1);
+	text head(query.begin(), query.begin() + n), tail(query.rbegin(), query.rbegin() + n);
+	if(predict_count(head) <= searcher.predict_count(tail)){
+		approx(query, max_edits, bi);
 		return;
 	}
+
+	std::vector<typename reversed_searcher_type::approximate_search_result> results;
+	searcher.approx(text(query.rbegin(), query.rend()), max_edits, std::back_inserter(results));
+	for(auto& r: results){
+		std::reverse(r.key.begin(), r.key.end());
+		*bi++ = {std::move(r.key), r.value, r.edits};
+	}
+}
+
+// tasks are appended in the order of approx_step(); returns the number of subtrees
+template<class trie, class approximate_matcher>
+std::size_t search_client<trie, approximate_matcher>::split(approximate_matcher& matcher, const length_range& lengths,
+	typename trie::node_type root, text& current, std::size_t depth, std::vector<approx_task>& tasks) const
+{
+	if(depth == 0){
+		tasks.push_back({{}, root, current, matcher});
+		return 1;
+	}
+
+	std::size_t subtrees = 0;
+	if(root.match() && matcher.matched()){
+		if(tasks.empty() || tasks.back().root)
+			tasks.emplace_back();
+		tasks.back().results.push_back({current, root.value(), static_cast<integer>(matcher.distance())});
+	}
 	if(root.leaf())
-		return;
+		return subtrees;
 	for(const auto& n: root.children()){
-		if(matcher.update(n.label())){
+		if(reachable(n, lengths) && matcher.update(n.label())){
 			current.push_back(n.label());
-			approx_predict_step(max_edits, matcher, n, current, bi);
+			subtrees += split(matcher, lengths, n, current, depth - 1, tasks);
 			current.pop_back();
 			matcher.back();
 		}
 	}
+	return subtrees;
+}
+
+template<class trie, class approximate_matcher>
+template<class back_insert_iterator>
+void search_client<trie, approximate_matcher>::approx_topk(
+	const text& query, std::size_t k, integer max_edits, back_insert_iterator bi) const
+{
+	if(k > 0)
+		approx_ranked(query, max_edits, k, false, bi);
+}
+
+template<class trie, class approximate_matcher>
+template<class back_insert_iterator>
+typename search_client<trie, approximate_matcher>::integer
+search_client<trie, approximate_matcher>::approx_adaptive(
+	const text& query, std::size_t min_results, integer max_cap, back_insert_iterator bi) const
+{
+	return approx_ranked(query, max_cap, min_results, true, bi);
+}
+
+template<class trie, class approximate_matcher>
+template<class back_insert_iterator>
+typename search_client<trie, approximate_matcher>::integer
+search_client<trie, approximate_matcher>::approx_ranked(const text& query, integer max_edits,
+	std::size_t limit, bool whole_radius, back_insert_iterator& bi) const
+{
+	auto matcher = make_matcher(query, max_edits);
+	auto lengths = match_lengths(query, max_edits, false);
+
+	// reached nodes; index 0 is the root
+	struct entry
+	{
+		typename trie::node_type node;
+		std::size_t parent;
+	};
+	std::vector<entry> entries = {{T.root(), 0}};
+
+	// buckets of results and of nodes to expand for each number of edits, used as stacks to keep
+	// the matcher near its current path; since lower bounds never decrease along a path,
+	// a result is final when the buckets of fewer edits are empty
+	std::vector<std::vector<std::size_t>> results(max_edits + 1), nodes(max_edits + 1);
+	nodes[min_distance(matcher)].push_back(0);
+
+	// entries on the path the matcher has consumed, excluding the root
+	std::vector<std::size_t> path, target;
+	text key;
+	std::size_t found = 0;
+	for(integer edits = 0; edits <= max_edits; ++edits){
+		while(!results[edits].empty() || !nodes[edits].empty()){
+			if(!results[edits].empty()){
+				std::size_t e = results[edits].back();
+				results[edits].pop_back();
+				key.clear();
+				for(std::size_t i = e; i != 0; i = entries[i].parent)
+					key.push_back(entries[i].node.label());
+				std::reverse(key.begin(), key.end());
+				*bi++ = {key, entries[e].node.value(), edits};
+				if(++found == limit && !whole_radius)
+					return edits;
+				continue;
+			}
+
+			std::size_t e = nodes[edits].back();
+			nodes[edits].pop_back();
+
+			// move the matcher from the current path to the entry through their common ancestor
+			target.clear();
+			for(std::size_t i = e; i != 0; i = entries[i].parent)
+				target.push_back(i);
+			std::reverse(target.begin(), target.end());
+			std::size_t common = 0;
+			while(common < path.size() && common < target.size() && path[common] == target[common])
+				++common;
+			for(; path.size() > common; path.pop_back())
+				matcher.back();
+			for(std::size_t i = common; i < target.size(); ++i){
+				matcher.update(entries[target[i]].node.label());
+				path.push_back(target[i]);
+			}
+
+			auto node = entries[e].node;
+			if(node.match() && matcher.matched())
+				results[matcher.distance()].push_back(e);
+			if(node.leaf())
+				continue;
+			for(const auto& n: node.children()){
+				if(reachable(n, lengths) && matcher.update(n.label())){
+					nodes[min_distance(matcher)].push_back(entries.size());
+					entries.push_back({n, e});
+					matcher.back();
+				}
+			}
+		}
+		if(found >= limit)
+			return edits;
+	}
+
+	return max_edits;
+}
+
+template<class trie, class approximate_matcher>
+template<class back_insert_iterator>
+void search_client<trie, approximate_matcher>::approx_batch(
+	const std::vector<text>& queries, integer max_edits, back_insert_iterator bi) const
+{
+	std::vector<approximate_matcher> matchers;
+	matchers.reserve(queries.size());
+	std::vector<length_range> lengths;
+	std::vector<std::size_t> alive;
+	for(std::size_t i = 0; i < queries.size(); ++i){
+		matchers.push_back(make_matcher(queries[i], max_edits));
+		lengths.push_back(match_lengths(queries[i], max_edits, false));
+		alive.push_back(i);
+	}
+	text current;
+	approx_batch_step(matchers, lengths, alive, 0, T.root(), current, bi);
 }
 
+// alive[first:] holds the matchers that accept current, in query order
 template<class trie, class approximate_matcher>
 template<class back_insert_iterator>
-void search_client<trie, approximate_matcher>::correct_approx_predict_results(
-	integer max_edits, approximate_matcher& matcher, typename trie::node_type root,
-	text& current, integer prefix_edits, integer current_edits, back_insert_iterator& bi) const
+void search_client<trie, approximate_matcher>::approx_batch_step(
+	std::vector<approximate_matcher>& matchers, const std::vector<length_range>& lengths, std::vector<std::size_t>& alive,
+	std::size_t first, typename trie::node_type root, text& current, back_insert_iterator& bi) const
 {
+	const std::size_t last = alive.size();
 	if(root.match())
-		*bi++ = {current, root.value(), std::min(prefix_edits, current_edits), current_edits};
+		for(std::size_t j = first; j < last; ++j)
+			if(matchers[alive[j]].matched())
+				*bi++ = {alive[j], current, root.value(), static_cast<integer>(matchers[alive[j]].distance())};
 	if(root.leaf())
 		return;
 	for(const auto& n: root.children()){
-		current.push_back(n.label());
-		if(current_edits <= max_edits && current.size() <= matcher.pattern.size() && matcher.update(n.label())){
-			correct_approx_predict_results(max_edits, matcher, n, current,
-				std::min(prefix_edits, static_cast<integer>(matcher.distance())), matcher.distance(), bi);
-			matcher.back();
+		for(std::size_t j = first; j < last; ++j)
+			if(reachable(n, lengths[alive[j]]) && matchers[alive[j]].update(n.label()))
+				alive.push_back(alive[j]);
+		if(alive.size() > last){
+			current.push_back(n.label());
+			approx_batch_step(matchers, lengths, alive, last, n, current, bi);
+			current.pop_back();
+			for(std::size_t j = last; j < alive.size(); ++j)
+				matchers[alive[j]].back();
+			alive.resize(last);
+		}
+	}
+}
+
+template<class trie, class approximate_matcher>
+template<class back_insert_iterator>
+void search_client<trie, approximate_matcher>::approx_predict(
+	const text& query, integer max_edits, back_insert_iterator bi) const
+{
+	unlimited_meter m;
+	approx_predict_run(query, max_edits, std::numeric_limits<std::size_t>::max(), predict_order::trie, m, bi);
+}
+
+template<class trie, class approximate_matcher>
+template<class back_insert_iterator>
+search_status search_client<trie, approximate_matcher>::approx_predict(
+	const text& query, integer max_edits, const search_budget& budget, back_insert_iterator bi) const
+{
+	budget_meter m(budget);
+	approx_predict_run(query, max_edits, std::numeric_limits<std::size_t>::max(), predict_order::trie, m, bi);
+	return m.status();
+}
+
+template<class trie, class approximate_matcher>
+template<class back_insert_iterator>
+void search_client<trie, approximate_matcher>::approx_predict(const text& query, integer max_edits,
+	std::size_t max_results, predict_order order, back_insert_iterator bi) const
+{
+	unlimited_meter m;
+	approx_predict_run(query, max_edits, max_results, order, m, bi);
+}
+
+template<class trie, class approximate_matcher>
+template<class meter, class back_insert_iterator>
+void search_client<trie, approximate_matcher>::approx_predict_run(const text& query, integer max_edits,
+	std::size_t max_results, predict_order order, meter& m, back_insert_iterator& bi) const
+{
+	if(max_results == 0)
+		return;
+	auto lengths = match_lengths(query, max_edits, true);
+	if constexpr(resettable_matcher<approximate_matcher, text, integer>){
+		if(reuse && !scratch_busy){
+			scratch_guard guard(scratch_busy);
+			scratch_text.clear();
+			approx_predict_traverse(max_edits, reuse_matcher(query, max_edits), lengths, scratch_text, max_results, order, m, bi);
+			return;
+		}
+	}
+	auto matcher = make_matcher(query, max_edits);
+	text current;
+	approx_predict_traverse(max_edits, matcher, lengths, current, max_results, order, m, bi);
+}
+
+// depth-first search with an explicit stack; all keys below the first match on a path are results
+template<class trie, class approximate_matcher>
+template<class meter, class back_insert_iterator>
+void search_client<trie, approximate_matcher>::approx_predict_traverse(integer max_edits, approximate_matcher& matcher,
+	const length_range& lengths, text& current, std::size_t max_results, predict_order order,
+	meter& m, back_insert_iterator& bi) const
+{
+	using child_iterator = decltype(T.root().children().begin());
+	struct frame
+	{
+		typename trie::node_type node;
+		child_iterator next;
+		child_iterator last;
+		// whether the matcher has consumed the label of the node
+		bool consumed;
+		// below a node where the query matched
+		bool completing;
+		integer prefix_edits;
+		integer current_edits;
+	};
+	auto make_frame = [](typename trie::node_type node, bool consumed, bool completing,
+			integer prefix_edits, integer current_edits){
+		auto children = node.children();
+		return frame{node, children.begin(), children.end(), consumed, completing, prefix_edits, current_edits};
+	};
+
+	// kept results for ordered search, as a max-heap of (rank, sequence number)
+	struct candidate
+	{
+		std::size_t rank;
+		std::size_t sequence;
+		approximate_predictive_search_result result;
+	};
+	auto worse = [](const candidate& a, const candidate& b){
+		return a.rank < b.rank || (a.rank == b.rank && a.sequence < b.sequence);
+	};
+	std::vector<candidate> kept;
+	std::size_t found = 0;
+	bool full = false;
+
+	// returns false when no more results are needed
+	auto report = [&](const frame& f){
+		integer prefix_edits = std::min(f.prefix_edits, f.current_edits);
+		if(order == predict_order::trie){
+			if(!m.emit())
+				return false;
+			*bi++ = {current, f.node.value(), prefix_edits, f.current_edits};
+			return ++found < max_results;
+		}
+		std::size_t rank = order == predict_order::shortest_first ? current.size() : f.current_edits;
+		if(full && rank >= kept.front().rank)
+			return true;
+		kept.push_back({rank, found++, {current, f.node.value(), prefix_edits, f.current_edits}});
+		std::push_heap(kept.begin(), kept.end(), worse);
+		if(kept.size() > max_results){
+			std::pop_heap(kept.begin(), kept.end(), worse);
+			kept.pop_back();
+		}
+		full = kept.size() == max_results;
+		return true;
+	};
+	std::vector<frame> stack;
+	// whether the matcher is in the state of the node of f, which is on top of the stack
+	auto follows = [&](const frame& f){
+		return f.consumed || stack.size() == 1;
+	};
+	// lower bound of the rank of results below the node of f
+	auto below = [&](const frame& f) -> std::size_t {
+		if(order == predict_order::shortest_first)
+			return current.size() + 1;
+		if(!f.completing)
+			return min_distance(matcher);
+		return follows(f) ? std::min<std::size_t>(min_distance(matcher), f.current_edits + 1) : f.current_edits + 1;
+	};
+
+	auto enter = [&](frame&& f){
+		if(!f.completing && matcher.matched()){
+			f.completing = true;
+			f.prefix_edits = f.current_edits = static_cast<integer>(matcher.distance());
+		}
+		bool more = !f.completing || !f.node.match() || report(f);
+		stack.push_back(std::move(f));
+		return more;
+	};
+
+	bool more = enter(make_frame(T.root(), false, false, 0, 0));
+	while(more && !stack.empty()){
+		frame& f = stack.back();
+		if(f.next == f.last || f.node.leaf() || (full && below(f) >= kept.front().rank)){
+			if(f.consumed)
+				matcher.back();
+			if(stack.size() > 1)
+				current.pop_back();
+			stack.pop_back();
+			continue;
+		}
+
+		auto n = *f.next;
+		++f.next;
+		if(!m.enter())
+			break;
+		if(!f.completing){
+			if(reachable(n, lengths) && matcher.update(n.label())){
+				current.push_back(n.label());
+				more = enter(make_frame(n, true, false, 0, 0));
+			}
 		}
 		else{
-			correct_approx_predict_results(max_edits, matcher, n, current, prefix_edits, current_edits + 1, bi);
+			bool follow = follows(f);
+			integer prefix_edits = f.prefix_edits, current_edits = f.current_edits;
+			current.push_back(n.label());
+			if(follow && current_edits <= max_edits && current.size() <= matcher.pattern.size() && matcher.update(n.label())){
+				integer edits = static_cast<integer>(matcher.distance());
+				more = enter(make_frame(n, true, true, std::min(prefix_edits, edits), edits));
+			}
+			else{
+				more = enter(make_frame(n, false, true, prefix_edits, current_edits + 1));
+			}
 		}
-		current.pop_back();
+	}
+
+	std::sort(kept.begin(), kept.end(), worse);
+	for(auto& c: kept){
+		if(!m.emit())
+			break;
+		*bi++ = {std::move(c.result.key), c.result.value, c.result.edits_prefix, c.result.edits_whole};
 	}
 }
 
@@ -0,0 +1,76 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Number of keys in each subtree of a trie
+*/
+
+#ifndef TRIMATCH_SUBTREE_COUNTS
+#define TRIMATCH_SUBTREE_COUNTS
+
+#include <cstdint>
+
+#include "node_annotation.hpp"
+
+namespace trimatch{
+
+template<typename integer = std::uint32_t>
+class subtree_counts: public node_annotation<integer, 1>
+{
+public:
+	template<class trie>
+	void build(const trie& T);
+
+	// number of keys below node id, including the node itself
+	integer count(integer id) const;
+
+private:
+	template<class node_type>
+	integer count_subtree(node_type node);
+};
+
+template<typename integer>
+template<class trie>
+void subtree_counts<integer>::build(const trie& T)
+{
+	this->data[0].assign(T.node_size(), 0);
+	count_subtree(T.root());
+}
+
+template<typename integer>
+template<class node_type>
+integer subtree_counts<integer>::count_subtree(node_type node)
+{
+	integer n = node.match() ? 1 : 0;
+	if(!node.leaf())
+		for(const auto& c: node.children())
+			n += count_subtree(c);
+	this->data[0][node.id()] = n;
+	return n;
+}
+
+template<typename integer>
+inline integer subtree_counts<integer>::count(integer id) const
+{
+	return this->data[0][id];
+}
+
+}
+
+#endif
@@ -0,0 +1,277 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Universal (parametric) Levenshtein automata based on Mihov and Schulz
+https://doi.org/10.1162/0891201042544938
+
+A state holds the edits of the 2 * max_edits + 1 pattern positions around
+the current depth, so transitions only depend on the characteristic vector
+of the input symbol in that window. Transition tables are built once per
+max_edits and shared by all queries.
+*/
+
+#ifndef TRIMATCH_UNIVERSAL_LEVENSHTEIN_AUTOMATON
+#define TRIMATCH_UNIVERSAL_LEVENSHTEIN_AUTOMATON
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <stdexcept>
+
+namespace trimatch
+{
+
+template<
+	typename text,
+	typename integer = std::uint32_t
+>
+class UniversalLevenshteinAutomaton
+{
+public:
+	using symbol = typename text::value_type;
+
+	struct table;
+
+	static constexpr integer max_supported_edits = 3;
+
+	text pattern;
+	integer max_edits;
+
+	UniversalLevenshteinAutomaton(const text& pattern, integer max_edits);
+
+	// start over with another pattern
+	void reset(const text& pattern, integer max_edits);
+
+	bool update(symbol c);
+	bool matched() const;
+	void back();
+	integer max_distance() const;
+	integer distance() const;
+	// lower bound of edits for any continuation
+	integer min_distance() const;
+
+private:
+	const table* T;
+	integer width;
+
+	std::vector<std::uint16_t> current_states;
+
+	static const table& get_table(integer max_edits);
+
+	integer depth() const;
+	integer keep(integer depth) const;
+};
+
+template<typename text, typename integer>
+struct UniversalLevenshteinAutomaton<text, integer>::table
+{
+	using state_id = std::uint16_t;
+
+	integer max_edits;
+	integer width;
+	integer columns;
+
+	// edits of each position in the window; max_edits + 1 means unreachable
+	std::vector<std::uint8_t> edits;
+	std::vector<std::uint8_t> min_edits;
+
+	// next state for each characteristic vector
+	std::vector<state_id> next;
+	// same state with positions after the given count removed
+	std::vector<state_id> truncated;
+
+	state_id initial;
+
+	table(integer max_edits);
+
+	state_id size() const;
+};
+
+template<typename text, typename integer>
+UniversalLevenshteinAutomaton<text, integer>::table::table(integer max_edits):
+	max_edits(max_edits), width(2 * max_edits + 1), columns(integer{1} << width)
+{
+	const std::uint8_t dead = static_cast<std::uint8_t>(max_edits + 1);
+
+	std::vector<std::vector<std::uint8_t>> vectors;
+	// keyed on the bytes of the vectors
+	std::map<std::string, state_id> ids;
+	auto find_or_add = [&](const std::vector<std::uint8_t>& v) -> state_id{
+		std::string key(v.begin(), v.end());
+		auto p = ids.lower_bound(key);
+		if(p != ids.end() && p->first == key)
+			return p->second;
+		state_id id = static_cast<state_id>(vectors.size());
+		ids.emplace_hint(p, std::move(key), id);
+		vectors.push_back(v);
+		return id;
+	};
+
+	// state 0 is the dead state
+	find_or_add(std::vector<std::uint8_t>(width, dead));
+
+	// depth 0: position j has j edits (deletions), window starts at -max_edits
+	std::vector<std::uint8_t> v(width, dead);
+	for(integer k = max_edits; k < width; ++k)
+		v[k] = static_cast<std::uint8_t>(k - max_edits);
+	initial = find_or_add(v);
+
+	// breadth-first construction over all characteristic vectors and truncations
+	std::vector<std::uint8_t> w(width);
+	for(state_id s = 0; s < vectors.size(); ++s){
+		for(integer x = 0; x < columns; ++x){
+			const auto& u = vectors[s];
+			for(integer k = 0; k < width; ++k){
+				std::uint8_t d = static_cast<std::uint8_t>(u[k] + ((x >> k) & 1 ? 0 : 1)); // substitution
+				if(k + 1 < width)
+					d = std::min(d, static_cast<std::uint8_t>(u[k + 1] + 1)); // insertion
+				if(k > 0)
+					d = std::min(d, static_cast<std::uint8_t>(w[k - 1] + 1)); // deletion
+				w[k] = std::min(d, dead);
+			}
+			next.push_back(find_or_add(w));
+		}
+		for(integer n = 0; n <= width; ++n){
+			w = vectors[s];
+			std::fill(w.begin() + n, w.end(), dead);
+			truncated.push_back(find_or_add(w));
+		}
+	}
+
+	for(const auto& u: vectors){
+		edits.insert(edits.end(), u.begin(), u.end());
+		min_edits.push_back(*std::min_element(u.begin(), u.end()));
+	}
+}
+
+template<typename text, typename integer>
+typename UniversalLevenshteinAutomaton<text, integer>::table::state_id
+UniversalLevenshteinAutomaton<text, integer>::table::size() const
+{
+	return static_cast<state_id>(min_edits.size());
+}
+
+template<typename text, typename integer>
+const typename UniversalLevenshteinAutomaton<text, integer>::table&
+UniversalLevenshteinAutomaton<text, integer>::get_table(integer max_edits)
+{
+	if(max_edits > max_supported_edits)
+		throw std::invalid_argument("UniversalLevenshteinAutomaton: max_edits must be at most 3");
+
+	static const table tables[] = {table(0), table(1), table(2), table(3)};
+	return tables[max_edits];
+}
+
+template<typename text, typename integer>
+UniversalLevenshteinAutomaton<text, integer>::UniversalLevenshteinAutomaton(const text& pattern, integer max_edits):
+	pattern(pattern), max_edits(max_edits), T(&get_table(max_edits)), width(T->width)
+{
+	current_states.reserve(pattern.size() + max_edits + 1);
+	current_states.push_back(T->truncated[T->initial * (width + 1) + keep(0)]);
+}
+
+template<typename text, typename integer>
+void UniversalLevenshteinAutomaton<text, integer>::reset(const text& pattern, integer max_edits)
+{
+	T = &get_table(max_edits);
+	width = T->width;
+	this->pattern = pattern;
+	this->max_edits = max_edits;
+	current_states.clear();
+	current_states.push_back(T->truncated[T->initial * (width + 1) + keep(0)]);
+}
+
+template<typename text, typename integer>
+inline integer UniversalLevenshteinAutomaton<text, integer>::depth() const
+{
+	return static_cast<integer>(current_states.size() - 1);
+}
+
+// number of window positions that are still inside the pattern
+template<typename text, typename integer>
+inline integer UniversalLevenshteinAutomaton<text, integer>::keep(integer depth) const
+{
+	// window covers pattern positions [depth - max_edits, depth + max_edits]
+	auto end = static_cast<integer>(pattern.size()) + max_edits + 1;
+	return end <= depth ? 0 : std::min(end - depth, width);
+}
+
+template<typename text, typename integer>
+inline bool UniversalLevenshteinAutomaton<text, integer>::update(const symbol c)
+{
+	// characteristic vector of c over pattern positions [depth - max_edits, depth + max_edits]
+	integer d = depth();
+	integer first = d < max_edits ? max_edits - d : 0, last = keep(d);
+	std::uint32_t x = 0;
+	for(integer k = first; k < last; ++k)
+		x |= static_cast<std::uint32_t>(pattern[d + k - max_edits] == c) << k;
+
+	auto next = T->next[current_states.back() * T->columns + x];
+	next = T->truncated[next * (width + 1) + keep(d + 1)];
+	bool updatable = next != 0;
+	if(updatable)
+		current_states.push_back(next);
+
+	return updatable;
+}
+
+template<typename text, typename integer>
+inline bool UniversalLevenshteinAutomaton<text, integer>::matched() const
+{
+	// the end of pattern is at window position pattern.size() - depth + max_edits
+	integer d = depth(), m = static_cast<integer>(pattern.size());
+	return m + max_edits >= d && m + max_edits - d < width &&
+		T->edits[current_states.back() * width + m + max_edits - d] <= max_edits;
+}
+
+template<typename text, typename integer>
+inline void UniversalLevenshteinAutomaton<text, integer>::back()
+{
+	if(current_states.size() > 1)
+		current_states.pop_back();
+}
+
+template<typename text, typename integer>
+inline integer UniversalLevenshteinAutomaton<text, integer>::max_distance() const
+{
+	return max_edits;
+}
+
+template<typename text, typename integer>
+inline integer UniversalLevenshteinAutomaton<text, integer>::distance() const
+{
+	if(matched())
+		return T->edits[current_states.back() * width + pattern.size() + max_edits - depth()];
+	else
+		return T->min_edits[current_states.back()];
+}
+
+template<typename text, typename integer>
+inline integer UniversalLevenshteinAutomaton<text, integer>::min_distance() const
+{
+	return T->min_edits[current_states.back()];
+}
+
+}
+
+#endif
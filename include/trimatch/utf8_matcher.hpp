@@ -0,0 +1,285 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+Adapter for tries of UTF-8 byte strings, which counts edits per code point.
+
+Bytes are buffered until a code point is complete, and then passed to a
+matcher over code points. Bytes which cannot start a code point and bytes
+of broken or truncated multibyte sequences are treated as single symbols
+in both the pattern and the keys, so every key matches itself.
+*/
+
+#ifndef TRIMATCH_UTF8_MATCHER
+#define TRIMATCH_UTF8_MATCHER
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "levenshtein_dfa.hpp"
+
+namespace trimatch
+{
+
+template<
+	typename text = std::string,
+	typename integer = std::uint32_t,
+	typename code_point_matcher = LevenshteinDFA<std::u32string, integer>
+>
+class UTF8Matcher
+{
+public:
+	using symbol = typename text::value_type;
+
+	// an edit of a code point changes the length in bytes by at most 4
+	static constexpr std::size_t symbols_per_edit = 4;
+
+	// pattern in bytes
+	text pattern;
+
+	UTF8Matcher(const text& pattern, integer max_edits);
+
+	// start over with another pattern, if the code point matcher supports it
+	void reset(const text& pattern, integer max_edits)
+		requires requires(code_point_matcher& m, const std::u32string& p, integer k){ m.reset(p, k); };
+
+	bool update(symbol c);
+	bool matched() const;
+	void back();
+	integer max_distance() const;
+	integer distance() const;
+	integer min_distance() const
+		requires requires(const code_point_matcher& m){ m.min_distance(); };
+
+	static std::u32string decode(const text& bytes);
+	static void decode(const text& bytes, std::u32string& code_points);
+
+private:
+	// code point being read and number of its remaining bytes
+	struct state
+	{
+		char32_t partial;
+		std::uint8_t remaining;
+		// bytes of the incomplete code point read so far, or 0
+		std::uint8_t pending;
+		// updates of the code point matcher made by the byte
+		std::uint8_t updates;
+		unsigned char byte;
+	};
+
+	std::u32string code_points;
+	// updated and restored by const members to read an incomplete code point as single bytes
+	mutable code_point_matcher matcher;
+
+	std::vector<state> states;
+
+	// passes the bytes of the incomplete code point to the matcher as single symbols
+	bool update_pending() const;
+	void back(std::size_t updates) const;
+
+	static std::uint8_t length(unsigned char lead);
+	static char32_t single(unsigned char c);
+};
+
+template<typename text, typename integer, typename code_point_matcher>
+UTF8Matcher<text, integer, code_point_matcher>::UTF8Matcher(const text& pattern, integer max_edits):
+	pattern(pattern), code_points(decode(pattern)), matcher(code_points, max_edits)
+{
+	states.push_back({0, 0, 0, 0, 0});
+}
+
+template<typename text, typename integer, typename code_point_matcher>
+void UTF8Matcher<text, integer, code_point_matcher>::reset(const text& pattern, integer max_edits)
+	requires requires(code_point_matcher& m, const std::u32string& p, integer k){ m.reset(p, k); }
+{
+	this->pattern = pattern;
+	decode(this->pattern, code_points);
+	matcher.reset(code_points, max_edits);
+	states.clear();
+	states.push_back({0, 0, 0, 0, 0});
+}
+
+template<typename text, typename integer, typename code_point_matcher>
+inline bool UTF8Matcher<text, integer, code_point_matcher>::update(const symbol c)
+{
+	const auto b = static_cast<unsigned char>(c);
+	const auto current = states.back();
+
+	std::uint8_t updates = 0;
+	if(current.remaining > 0){
+		if((b & 0xc0) == 0x80){
+			state next{(current.partial << 6) | (b & 0x3f), static_cast<std::uint8_t>(current.remaining - 1),
+				static_cast<std::uint8_t>(current.pending + 1), 0, b};
+			if(next.remaining == 0){
+				if(!matcher.update(next.partial))
+					return false;
+				next.pending = 0;
+				next.updates = 1;
+			}
+			states.push_back(next);
+			return true;
+		}
+		// the sequence is broken; its bytes are single symbols, and b starts over as decode() does
+		if(!update_pending())
+			return false;
+		updates = current.pending;
+	}
+
+	auto n = length(b);
+	if(n > 1){
+		states.push_back({static_cast<char32_t>(b & (0x7f >> n)), static_cast<std::uint8_t>(n - 1), 1, updates, b});
+		return true;
+	}
+	if(!matcher.update(n == 1 ? static_cast<char32_t>(b) : single(b))){
+		back(updates);
+		return false;
+	}
+	states.push_back({0, 0, 0, static_cast<std::uint8_t>(updates + 1), b});
+	return true;
+}
+
+// a key ending with an incomplete code point is read with its bytes as single symbols
+template<typename text, typename integer, typename code_point_matcher>
+inline bool UTF8Matcher<text, integer, code_point_matcher>::matched() const
+{
+	auto pending = states.back().pending;
+	if(pending == 0)
+		return matcher.matched();
+	if(!update_pending())
+		return false;
+	bool result = matcher.matched();
+	back(pending);
+	return result;
+}
+
+template<typename text, typename integer, typename code_point_matcher>
+inline void UTF8Matcher<text, integer, code_point_matcher>::back()
+{
+	if(states.size() > 1){
+		back(states.back().updates);
+		states.pop_back();
+	}
+}
+
+template<typename text, typename integer, typename code_point_matcher>
+bool UTF8Matcher<text, integer, code_point_matcher>::update_pending() const
+{
+	auto pending = states.back().pending;
+	for(std::size_t i = 0; i < pending; ++i){
+		if(!matcher.update(single(states[states.size() - pending + i].byte))){
+			back(i);
+			return false;
+		}
+	}
+	return true;
+}
+
+template<typename text, typename integer, typename code_point_matcher>
+inline void UTF8Matcher<text, integer, code_point_matcher>::back(std::size_t updates) const
+{
+	for(std::size_t i = 0; i < updates; ++i)
+		matcher.back();
+}
+
+template<typename text, typename integer, typename code_point_matcher>
+inline integer UTF8Matcher<text, integer, code_point_matcher>::max_distance() const
+{
+	return matcher.max_distance();
+}
+
+template<typename text, typename integer, typename code_point_matcher>
+inline integer UTF8Matcher<text, integer, code_point_matcher>::distance() const
+{
+	auto pending = states.back().pending;
+	if(pending == 0 || !update_pending())
+		return matcher.distance();
+	integer result = matcher.distance();
+	back(pending);
+	return result;
+}
+
+template<typename text, typename integer, typename code_point_matcher>
+inline integer UTF8Matcher<text, integer, code_point_matcher>::min_distance() const
+	requires requires(const code_point_matcher& m){ m.min_distance(); }
+{
+	return matcher.min_distance();
+}
+
+template<typename text, typename integer, typename code_point_matcher>
+std::u32string UTF8Matcher<text, integer, code_point_matcher>::decode(const text& bytes)
+{
+	std::u32string code_points;
+	decode(bytes, code_points);
+	return code_points;
+}
+
+template<typename text, typename integer, typename code_point_matcher>
+void UTF8Matcher<text, integer, code_point_matcher>::decode(const text& bytes, std::u32string& code_points)
+{
+	code_points.clear();
+	for(std::size_t i = 0; i < bytes.size();){
+		auto b = static_cast<unsigned char>(bytes[i]);
+		std::size_t n = length(b);
+		bool valid = n > 1 && i + n <= bytes.size();
+		for(std::size_t j = 1; valid && j < n; ++j)
+			valid = (static_cast<unsigned char>(bytes[i + j]) & 0xc0) == 0x80;
+		if(valid){
+			char32_t c = b & (0x7f >> n);
+			for(std::size_t j = 1; j < n; ++j)
+				c = (c << 6) | (static_cast<unsigned char>(bytes[i + j]) & 0x3f);
+			code_points.push_back(c);
+			i += n;
+		}
+		else{
+			code_points.push_back(n == 1 ? static_cast<char32_t>(b) : single(b));
+			++i;
+		}
+	}
+}
+
+// number of bytes of the code point starting with lead; 0 if lead cannot start one
+template<typename text, typename integer, typename code_point_matcher>
+inline std::uint8_t UTF8Matcher<text, integer, code_point_matcher>::length(unsigned char lead)
+{
+	if(lead < 0x80)
+		return 1;
+	else if(lead < 0xc2)
+		return 0;
+	else if(lead < 0xe0)
+		return 2;
+	else if(lead < 0xf0)
+		return 3;
+	else if(lead < 0xf5)
+		return 4;
+	else
+		return 0;
+}
+
+// stray bytes are mapped to lone surrogates, which no valid code point uses
+template<typename text, typename integer, typename code_point_matcher>
+inline char32_t UTF8Matcher<text, integer, code_point_matcher>::single(unsigned char c)
+{
+	return 0xdc00 + c;
+}
+
+}
+
+#endif
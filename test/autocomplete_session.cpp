@@ -0,0 +1,127 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <limits>
+#include <algorithm>
+
+#include <Catch2/catch.hpp>
+
+#include <trimatch/index.hpp>
+
+
+using text = std::string;
+using integer = std::uint32_t;
+
+
+// edits between the query and the closest prefix of the key
+static integer prefix_distance(const text& query, const text& key)
+{
+	std::vector<integer> previous(key.size() + 1), next(key.size() + 1);
+	for(integer j = 0; j <= key.size(); ++j)
+		previous[j] = j;
+	for(integer i = 1; i <= query.size(); ++i){
+		next[0] = i;
+		for(integer j = 1; j <= key.size(); ++j)
+			next[j] = std::min({previous[j] + 1, next[j - 1] + 1, previous[j - 1] + (query[i - 1] == key[j - 1] ? 0 : 1)});
+		std::swap(previous, next);
+	}
+	return *std::min_element(previous.begin(), previous.end());
+}
+
+TEST_CASE("autocomplete_session / small dictionary", "[index][predict][approx][session]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMP",
+		"AMPLIFIER",
+		"CA",
+		"CAD",
+		"CAM",
+		"CAMP",
+		"CAMPAIGN",
+		"CAMPING",
+		"CM",
+		"CMD",
+		"DM",
+		"MD",
+	};
+	sftrie::sort_texts(texts.begin(), texts.end());
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto searcher = index.searcher();
+
+	auto check_results = [&](const auto& session){
+		std::map<text, integer> expected;
+		for(const auto& t: texts){
+			integer edits = prefix_distance(session.query(), t);
+			if(edits <= session.max_distance())
+				expected[t] = edits;
+		}
+
+		std::vector<std::tuple<text, bool, integer>> results;
+		session.results(std::numeric_limits<std::size_t>::max(), std::back_inserter(results));
+		std::map<text, integer> actual;
+		for(const auto& [key, value, edits]: results)
+			actual[key] = edits;
+		CHECK(actual.size() == results.size());
+		CHECK(actual == expected);
+		CHECK(std::is_sorted(results.begin(), results.end(), [](const auto& a, const auto& b){
+			return std::get<2>(a) < std::get<2>(b);
+		}));
+
+		for(std::size_t k = 0; k <= results.size(); ++k){
+			std::vector<std::tuple<text, bool, integer>> limited;
+			session.results(k, std::back_inserter(limited));
+			CHECK(limited == std::vector<std::tuple<text, bool, integer>>(results.begin(), results.begin() + k));
+		}
+	};
+
+	for(integer max_edits = 0; max_edits <= 2; ++max_edits){
+		SECTION("typing, max edits = " + std::to_string(max_edits)){
+			for(const text query: {"CAMPING", "AMPLFIER", "XCAMP", "MDX"}){
+				auto session = searcher.session(max_edits);
+				check_results(session);
+				for(const auto c: query){
+					session.push(c);
+					check_results(session);
+				}
+			}
+		}
+		SECTION("deleting, max edits = " + std::to_string(max_edits)){
+			auto session = searcher.session(max_edits);
+			for(const auto c: text("CAMX"))
+				session.push(c);
+			session.pop();
+			CHECK(session.query() == "CAM");
+			check_results(session);
+			session.push('P');
+			CHECK(session.query() == "CAMP");
+			check_results(session);
+			for(int i = 0; i < 5; ++i)
+				session.pop();
+			CHECK(session.query().empty());
+			check_results(session);
+		}
+	}
+}
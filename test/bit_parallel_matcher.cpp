@@ -0,0 +1,187 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include <Catch2/catch.hpp>
+
+#include <trimatch/index.hpp>
+#include <trimatch/bit_parallel_matcher.hpp>
+
+
+using text = std::string;
+using symbol = typename text::value_type;
+using integer = std::uint32_t;
+
+
+TEST_CASE("bit_parallel_matcher / small pattern", "[BP][approx]"){
+	text pattern = "CORP";
+
+	std::vector<text> texts0 = {
+		"CORP",
+	};
+
+	std::vector<text> texts1 = {
+		"ORP",
+		"COP",
+		"COR",
+		"CCORP",
+		"COORP",
+		"CORPS",
+		"KORP",
+		"CARP",
+		"CORE",
+	};
+
+	std::vector<text> texts2 = {
+		"RP",
+		"CO",
+		"CR",
+		"CORPUS",
+		"RECORP",
+		"COORRP",
+		"CAMP",
+		"LORD",
+		"CARE",
+	};
+
+	for(integer max_edits = 0; max_edits <= 2; ++max_edits){
+		SECTION("max edits = " + std::to_string(max_edits)){
+			integer edits = 0;
+			for(const auto& texts: {texts0, texts1, texts2}){
+				for(const auto& text: texts){
+					trimatch::BitParallelMatcher<std::string, integer> matcher(pattern, max_edits);
+					bool passed = true;
+					for(const auto s: text){
+						if(!matcher.update(s)){
+							passed = false;
+							break;
+						}
+					}
+					bool matched = passed && matcher.matched();
+					CHECK(matched == (edits <= max_edits));
+					if(matched)
+						CHECK(matcher.distance() == edits);
+				}
+				++edits;
+			}
+		}
+	}
+}
+
+TEST_CASE("bit_parallel_matcher / long pattern", "[BP][approx]"){
+	// longer than a 64-bit word
+	text pattern;
+	for(int i = 0; i < 10; ++i)
+		pattern += "ABCDEFGHIJKLM";
+
+	SECTION("max edits = 2"){
+		trimatch::BitParallelMatcher<text, integer> matcher(pattern, 2);
+		text t = pattern;
+		t[3] = 'X';
+		t.erase(100, 1);
+		for(const auto s: t)
+			CHECK(matcher.update(s));
+		CHECK(matcher.matched());
+		CHECK(matcher.distance() == 2);
+		CHECK_FALSE(matcher.update('M'));
+		CHECK(matcher.matched());
+		matcher.back();
+		CHECK(matcher.update('M'));
+		CHECK(matcher.matched());
+		CHECK(matcher.distance() == 2);
+	}
+	SECTION("pruned in the middle"){
+		trimatch::BitParallelMatcher<text, integer> matcher(pattern, 1);
+		for(integer i = 0; i < 70; ++i)
+			CHECK(matcher.update(pattern[i]));
+		CHECK(matcher.update('X'));
+		CHECK(matcher.distance() == 1);
+		CHECK_FALSE(matcher.update('X'));
+	}
+}
+
+TEST_CASE("bit_parallel_matcher / reset", "[BP][approx]"){
+	text pattern;
+	for(int i = 0; i < 10; ++i)
+		pattern += "ABCDEFGHIJKLM";
+
+	trimatch::BitParallelMatcher<text, integer> matcher(pattern, 2);
+	for(integer i = 0; i < 80; ++i)
+		CHECK(matcher.update(pattern[i]));
+
+	SECTION("shorter pattern"){
+		matcher.reset("CORP", 1);
+		for(const auto s: text("CARP"))
+			CHECK(matcher.update(s));
+		CHECK(matcher.matched());
+		CHECK(matcher.distance() == 1);
+		CHECK_FALSE(matcher.update('X'));
+	}
+	SECTION("same pattern again"){
+		matcher.reset(pattern, 0);
+		for(const auto s: pattern)
+			CHECK(matcher.update(s));
+		CHECK(matcher.matched());
+		CHECK(matcher.distance() == 0);
+	}
+}
+
+TEST_CASE("bit_parallel_matcher / approximate search on index", "[index][approx][BP]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMP",
+		"CAD",
+		"CA",
+		"CAM",
+		"CAMP",
+		"CM",
+		"CMD",
+		"DM",
+		"MD",
+	};
+	sftrie::sort_texts(texts.begin(), texts.end());
+
+	using trie_type = typename trimatch::trie_selector<sftrie::empty>::template trie_type<text, integer>;
+	using index_type = trimatch::index<text, sftrie::empty, integer, trie_type, trimatch::BitParallelMatcher<text, integer>>;
+	index_type index(texts);
+	auto searcher = index.searcher();
+	auto dfa_index = trimatch::build(texts);
+	auto dfa_searcher = dfa_index.searcher();
+
+	SECTION("same results as DFA"){
+		for(const text query: {"AD", "CORP", "CMP", "MA"}){
+			for(integer max_edits = 0; max_edits <= 2; ++max_edits){
+				std::vector<std::tuple<text, unsigned long, unsigned long>> results, expected;
+				searcher.approx(query, max_edits, std::back_inserter(results));
+				dfa_searcher.approx(query, max_edits, std::back_inserter(expected));
+				CHECK(results == expected);
+
+				std::vector<std::tuple<text, unsigned long, unsigned long, unsigned long>> predicted, expected_predicted;
+				searcher.approx_predict(query, max_edits, std::back_inserter(predicted));
+				dfa_searcher.approx_predict(query, max_edits, std::back_inserter(expected_predicted));
+				CHECK(predicted == expected_predicted);
+			}
+		}
+	}
+}
@@ -0,0 +1,111 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+
+#include <Catch2/catch.hpp>
+
+#include <trimatch/damerau_levenshtein_dfa.hpp>
+
+
+using text = std::string;
+using symbol = typename text::value_type;
+using integer = std::uint32_t;
+
+
+TEST_CASE("damerau_levenshtein_dfa / small pattern", "[DFA][approx]"){
+	text pattern = "CORP";
+
+	std::vector<text> texts0 = {
+		"CORP",
+	};
+
+	std::vector<text> texts1 = {
+		"OCRP",
+		"CROP",
+		"COPR",
+		"ORP",
+		"COP",
+		"CCORP",
+		"CORPS",
+		"KORP",
+		"CARP",
+	};
+
+	std::vector<text> texts2 = {
+		"OCPR",
+		"ROCP",
+		"CROPS",
+		"RCOP",
+		"CORPUS",
+		"RECORP",
+		"CAMP",
+		"LORD",
+	};
+
+	for(integer max_edits = 0; max_edits <= 2; ++max_edits){
+		SECTION("max edits = " + std::to_string(max_edits)){
+			integer edits = 0;
+			for(const auto& texts: {texts0, texts1, texts2}){
+				for(const auto& text: texts){
+					auto dfa = trimatch::DamerauLevenshteinDFA(pattern, max_edits);
+					bool passed = true;
+					for(const auto s: text){
+						if(!dfa.update(s)){
+							passed = false;
+							break;
+						}
+					}
+					bool matched = passed && dfa.matched();
+					CHECK(matched == (edits <= max_edits));
+					if(matched)
+						CHECK(dfa.distance() == edits);
+				}
+				++edits;
+			}
+		}
+	}
+}
+
+TEST_CASE("damerau_levenshtein_dfa / transposition of repeated symbols", "[DFA][approx]"){
+	text pattern = "TEH";
+
+	SECTION("max edits = 1"){
+		auto dfa = trimatch::DamerauLevenshteinDFA(pattern, integer{1});
+		CHECK(dfa.update('T'));
+		CHECK(dfa.update('H'));
+		CHECK(dfa.update('E'));
+		CHECK(dfa.matched());
+		CHECK(dfa.distance() == 1);
+		dfa.back();
+		dfa.back();
+		CHECK(dfa.update('E'));
+		CHECK(dfa.update('H'));
+		CHECK(dfa.matched());
+		CHECK(dfa.distance() == 0);
+	}
+	SECTION("restricted: no edits inside a transposed pair"){
+		// "CA" -> "AC" -> "ABC" needs 3 edits under optimal string alignment
+		auto dfa = trimatch::DamerauLevenshteinDFA(text("CA"), integer{2});
+		CHECK(dfa.update('A'));
+		CHECK(dfa.update('B'));
+		CHECK_FALSE((dfa.update('C') && dfa.matched()));
+	}
+}
@@ -18,6 +18,11 @@ limitations under the License.
 */
 
 #include <string>
+#include <sstream>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <stdexcept>
 
 #include <Catch2/catch.hpp>
 
@@ -143,3 +148,328 @@ TEST_CASE("index / exact matching / small dictionary", "[index][exact]"){
 		CHECK_FALSE(searcher.exact("CAMP"));
 	}
 }
+
+TEST_CASE("index / length bounds", "[index][approx]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMPLIFIER",
+		"CAD",
+		"CAM",
+		"CAMPAIGN",
+		"CAMPING",
+		"CM",
+		"DM",
+		"MD",
+	};
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto plain = trimatch::build(texts.begin(), texts.end());
+	CHECK_FALSE(index.has_length_bounds());
+	index.build_length_bounds();
+	CHECK(index.has_length_bounds());
+
+	auto check_same_results = [&](const auto& searcher){
+		auto expected_searcher = plain.searcher();
+		for(const text query: {"AM", "CAMP", "CAMPING", "AMPLIFY", "X", ""}){
+			for(integer max_edits = 0; max_edits <= 2; ++max_edits){
+				std::vector<std::tuple<text, bool, integer>> results, expected;
+				searcher.approx(query, max_edits, std::back_inserter(results));
+				expected_searcher.approx(query, max_edits, std::back_inserter(expected));
+				CHECK(results == expected);
+
+				std::vector<text> iterated, expected_iterated;
+				for(auto i = searcher.approx(query, max_edits); i != i.end(); ++i)
+					iterated.emplace_back(i.key());
+				for(auto i = expected_searcher.approx(query, max_edits); i != i.end(); ++i)
+					expected_iterated.emplace_back(i.key());
+				CHECK(iterated == expected_iterated);
+
+				std::vector<std::tuple<text, bool, integer, integer>> predicted, expected_predicted;
+				searcher.approx_predict(query, max_edits, std::back_inserter(predicted));
+				expected_searcher.approx_predict(query, max_edits, std::back_inserter(expected_predicted));
+				CHECK(predicted == expected_predicted);
+			}
+		}
+	};
+
+	SECTION("same results as without bounds"){
+		check_same_results(index.searcher());
+	}
+	SECTION("save and load"){
+		std::stringstream ss;
+		index.save(ss);
+		trimatch::index<text> loaded;
+		loaded.load(ss);
+		CHECK(loaded.has_length_bounds());
+		check_same_results(loaded.searcher());
+	}
+	SECTION("save and load without bounds"){
+		std::stringstream ss;
+		plain.save(ss);
+		trimatch::index<text> loaded;
+		loaded.load(ss);
+		CHECK_FALSE(loaded.has_length_bounds());
+		check_same_results(loaded.searcher());
+	}
+	SECTION("load trie saved without length bounds section"){
+		std::stringstream ss;
+		plain.raw_trie().save(ss);
+		trimatch::index<text> loaded;
+		loaded.load(ss);
+		CHECK_FALSE(loaded.has_length_bounds());
+		check_same_results(loaded.searcher());
+	}
+	SECTION("load trie saved without length bounds section and followed by other data"){
+		std::stringstream ss;
+		plain.raw_trie().save(ss);
+		ss << "\x0f and more";
+		trimatch::index<text> loaded;
+		loaded.load(ss);
+		CHECK_FALSE(loaded.has_length_bounds());
+		check_same_results(loaded.searcher());
+		std::string rest;
+		std::getline(ss, rest);
+		CHECK(rest == "\x0f and more");
+	}
+	SECTION("unsupported version"){
+		std::stringstream ss;
+		index.save(ss);
+		std::stringstream trie_only;
+		index.raw_trie().save(trie_only);
+		std::string saved = ss.str();
+		// version follows the trie and the magic number
+		saved[trie_only.str().size() + 8] = 2;
+		std::stringstream modified(saved);
+		trimatch::index<text> loaded;
+		CHECK_THROWS_AS(loaded.load(modified), std::runtime_error);
+	}
+}
+
+TEST_CASE("index (map) / score bounds", "[index][predict][topk]"){
+	std::vector<std::pair<text, integer>> texts = {
+		{"A", 5},
+		{"AM", 2},
+		{"AMD", 9},
+		{"AMP", 1},
+		{"CA", 3},
+		{"CAD", 4},
+		{"CAM", 8},
+		{"CAMP", 6},
+		{"CM", 7},
+		{"DM", 0},
+	};
+
+	trimatch::index<text, integer> index(texts);
+	CHECK_FALSE(index.has_score_bounds());
+	std::vector<std::tuple<text, integer, double>> unscored;
+	CHECK_THROWS_AS(index.searcher().predict_topk("A", 1, std::back_inserter(unscored)), std::logic_error);
+	index.build_score_bounds([](integer value){ return value; });
+	CHECK(index.has_score_bounds());
+
+	auto check_topk = [&](const auto& searcher){
+		for(const text query: {"", "A", "CA", "CAMP", "X"}){
+			std::vector<std::tuple<text, integer, double>> expected;
+			for(const auto& [key, value]: texts)
+				if(key.substr(0, query.size()) == query)
+					expected.emplace_back(key, value, value);
+			std::sort(expected.begin(), expected.end(), [](const auto& a, const auto& b){
+				return std::get<2>(a) > std::get<2>(b);
+			});
+			for(std::size_t k = 0; k <= texts.size() + 1; ++k){
+				std::vector<std::tuple<text, integer, double>> results;
+				searcher.predict_topk(query, k, std::back_inserter(results));
+				CHECK(results == std::vector<std::tuple<text, integer, double>>(
+					expected.begin(), expected.begin() + std::min(k, expected.size())));
+			}
+		}
+	};
+
+	SECTION("top-k completions"){
+		check_topk(index.searcher());
+	}
+	SECTION("rebuilt with the trie"){
+		texts.pop_back();
+		texts[2].second = 0;
+		index.build(texts.begin(), texts.end());
+		CHECK(index.has_score_bounds());
+		check_topk(index.searcher());
+	}
+	SECTION("save and load"){
+		std::stringstream ss;
+		index.build_length_bounds();
+		index.save(ss);
+		trimatch::index<text, integer> loaded;
+		loaded.load(ss);
+		CHECK(loaded.has_length_bounds());
+		CHECK(loaded.has_score_bounds());
+		check_topk(loaded.searcher());
+	}
+}
+
+TEST_CASE("index / subtree counts", "[index][predict][approx][count]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMPLIFIER",
+		"CAD",
+		"CAM",
+		"CAMPAIGN",
+		"CAMPING",
+		"CM",
+		"DM",
+		"MD",
+	};
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	CHECK_FALSE(index.has_subtree_counts());
+
+	auto check_counts = [&](auto searcher){
+		for(const text query: {"", "A", "AM", "CAMP", "CAMPING", "CAMPINGS", "X"}){
+			std::vector<text> predicted;
+			searcher.predict(query, std::back_inserter(predicted));
+			CHECK(searcher.predict_count(query) == predicted.size());
+
+			for(integer max_edits = 0; max_edits <= 2; ++max_edits){
+				std::vector<std::tuple<text, bool, integer>> results;
+				searcher.approx(query, max_edits, std::back_inserter(results));
+				CHECK(searcher.approx_count(query, max_edits) == results.size());
+			}
+		}
+	};
+
+	SECTION("without counts"){
+		check_counts(index.searcher());
+	}
+	SECTION("with counts"){
+		index.build_subtree_counts();
+		CHECK(index.has_subtree_counts());
+		check_counts(index.searcher());
+	}
+	SECTION("rebuilt with the trie"){
+		index.build_subtree_counts();
+		texts.pop_back();
+		index.build(texts.begin(), texts.end());
+		CHECK(index.has_subtree_counts());
+		check_counts(index.searcher());
+		CHECK(index.searcher().predict_count("") == texts.size());
+	}
+	SECTION("save and load"){
+		index.build_subtree_counts();
+		std::stringstream ss;
+		index.save(ss);
+		trimatch::index<text> loaded;
+		loaded.load(ss);
+		CHECK(loaded.has_subtree_counts());
+		CHECK_FALSE(loaded.has_length_bounds());
+		check_counts(loaded.searcher());
+	}
+}
+
+TEST_CASE("index (map) / reversed keys", "[index][suffix][approx]"){
+	std::vector<std::pair<text, integer>> texts = {
+		{"A", 1},
+		{"AM", 2},
+		{"AMD", 3},
+		{"AMPLIFIER", 4},
+		{"CAD", 5},
+		{"CAM", 6},
+		{"CAMPAIGN", 7},
+		{"CAMPING", 8},
+		{"CM", 9},
+		{"DM", 10},
+		{"MD", 11},
+	};
+
+	trimatch::index<text, integer> index(texts);
+	CHECK_FALSE(index.has_reversed_keys());
+	std::vector<text> unavailable;
+	CHECK_THROWS_AS(index.searcher().suffix("M", std::back_inserter(unavailable)), std::logic_error);
+
+	// approx_suffix() is approx_predict() on the reversed keys
+	auto reverse = [](text t){
+		std::reverse(t.begin(), t.end());
+		return t;
+	};
+
+	auto check_suffixes = [&](auto searcher, bool with_counts){
+		std::vector<std::pair<text, integer>> reversed_texts;
+		for(const auto& [key, value]: texts)
+			reversed_texts.emplace_back(reverse(key), value);
+		std::sort(reversed_texts.begin(), reversed_texts.end());
+		trimatch::index<text, integer> reversed_index(reversed_texts);
+		auto reversed_searcher = reversed_index.searcher();
+
+		for(const text query: {"", "D", "M", "AM", "ING", "CAMPING", "XD"}){
+			std::vector<text> expected, actual;
+			for(const auto& [key, value]: texts)
+				if(key.size() >= query.size() && key.compare(key.size() - query.size(), query.size(), query) == 0)
+					expected.push_back(key);
+			searcher.suffix(query, std::back_inserter(actual));
+			std::sort(actual.begin(), actual.end());
+			CHECK(actual == expected);
+
+			for(integer max_edits = 0; max_edits <= 2; ++max_edits){
+				std::vector<std::tuple<text, integer, integer, integer>> expected_approx, actual_approx;
+				reversed_searcher.approx_predict(reverse(query), max_edits, std::back_inserter(expected_approx));
+				for(auto& r: expected_approx)
+					std::get<0>(r) = reverse(std::get<0>(r));
+				std::sort(expected_approx.begin(), expected_approx.end());
+				searcher.approx_suffix(query, max_edits, std::back_inserter(actual_approx));
+				std::sort(actual_approx.begin(), actual_approx.end());
+				CHECK(actual_approx == expected_approx);
+
+				std::vector<std::tuple<text, integer, integer>> forward, bidirectional;
+				if(!with_counts){
+					CHECK_THROWS_AS(searcher.approx_bidirectional(query, max_edits, std::back_inserter(bidirectional)),
+						std::logic_error);
+					continue;
+				}
+				searcher.approx(query, max_edits, std::back_inserter(forward));
+				std::sort(forward.begin(), forward.end());
+				searcher.approx_bidirectional(query, max_edits, std::back_inserter(bidirectional));
+				std::sort(bidirectional.begin(), bidirectional.end());
+				CHECK(bidirectional == forward);
+			}
+		}
+	};
+
+	SECTION("with reversed keys"){
+		index.build_reversed_keys();
+		CHECK(index.has_reversed_keys());
+		check_suffixes(index.searcher(), false);
+	}
+	SECTION("with reversed keys and subtree counts"){
+		index.build_reversed_keys();
+		index.build_subtree_counts();
+		check_suffixes(index.searcher(), true);
+	}
+	SECTION("copy of a searcher reusing its matcher"){
+		index.build_reversed_keys();
+		index.build_subtree_counts();
+		auto searcher = index.searcher();
+		searcher.enable_matcher_reuse();
+		auto copy = searcher;
+		check_suffixes(searcher, true);
+		check_suffixes(copy, true);
+	}
+	SECTION("rebuilt with the trie"){
+		index.build_reversed_keys();
+		texts.pop_back();
+		index.build(texts);
+		CHECK(index.has_reversed_keys());
+		check_suffixes(index.searcher(), false);
+	}
+	SECTION("save and load"){
+		index.build_reversed_keys();
+		std::stringstream ss;
+		index.save(ss);
+		trimatch::index<text, integer> loaded;
+		loaded.load(ss);
+		CHECK(loaded.has_reversed_keys());
+		CHECK_FALSE(loaded.has_subtree_counts());
+		check_suffixes(loaded.searcher(), false);
+	}
+}
@@ -0,0 +1,124 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+
+#include <Catch2/catch.hpp>
+
+#include <trimatch/lazy_levenshtein_dfa.hpp>
+
+
+using text = std::string;
+using symbol = typename text::value_type;
+using integer = std::uint32_t;
+
+
+namespace{
+
+bool accepts(trimatch::LazyLevenshteinDFA<text, integer>& dfa, const text& t)
+{
+	integer depth = 0;
+	bool passed = true;
+	for(const auto s: t){
+		if(!dfa.update(s)){
+			passed = false;
+			break;
+		}
+		++depth;
+	}
+	bool matched = passed && dfa.matched();
+	for(; depth > 0; --depth)
+		dfa.back();
+	return matched;
+}
+
+}
+
+
+TEST_CASE("lazy_levenshtein_dfa / small pattern", "[DFA][approx]"){
+	text pattern = "CORP";
+
+	std::vector<text> texts0 = {
+		"CORP",
+	};
+
+	std::vector<text> texts1 = {
+		"ORP",
+		"COP",
+		"COR",
+		"CCORP",
+		"COORP",
+		"CORPS",
+		"KORP",
+		"CARP",
+		"CORE",
+	};
+
+	std::vector<text> texts2 = {
+		"RP",
+		"CO",
+		"CR",
+		"CORPUS",
+		"RECORP",
+		"COORRP",
+		"CAMP",
+		"LORD",
+		"CARE",
+	};
+
+	for(integer max_states: {integer{1}, integer{4}, trimatch::LazyLevenshteinDFA<text, integer>::default_max_states}){
+		for(integer max_edits = 0; max_edits <= 2; ++max_edits){
+			SECTION("max edits = " + std::to_string(max_edits) + " / max states = " + std::to_string(max_states)){
+				// the same automaton is reused for all texts
+				trimatch::LazyLevenshteinDFA<text, integer> dfa(pattern, max_edits, max_states);
+				integer edits = 0;
+				for(const auto& texts: {texts0, texts1, texts2}){
+					for(const auto& t: texts)
+						CHECK(accepts(dfa, t) == (edits <= max_edits));
+					++edits;
+				}
+				CHECK(dfa.size() <= max_states);
+			}
+		}
+	}
+}
+
+TEST_CASE("lazy_levenshtein_dfa / materialization", "[DFA][approx]"){
+	trimatch::LazyLevenshteinDFA<text, integer> dfa("CORPORATION", 2);
+	CHECK(dfa.size() == 1);
+
+	CHECK(dfa.update('C'));
+	CHECK(dfa.update('O'));
+	auto size = dfa.size();
+	CHECK(size == 3);
+
+	// known transitions do not create states
+	dfa.back();
+	CHECK(dfa.update('O'));
+	CHECK(dfa.size() == size);
+
+	// all symbols outside the pattern share one transition
+	CHECK(dfa.update('X'));
+	size = dfa.size();
+	dfa.back();
+	CHECK(dfa.update('Y'));
+	CHECK(dfa.size() == size);
+	CHECK(dfa.distance() == 1);
+}
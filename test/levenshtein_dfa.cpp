@@ -204,3 +204,122 @@ TEST_CASE("levenshtein_dfa / small pattern", "[DFA][approx]"){
 		}
 	}
 }
+
+TEST_CASE("levenshtein_dfa / bytes outside ASCII", "[DFA][approx]"){
+	// "café" and "cafè" in UTF-8
+	text pattern = "caf\xc3\xa9";
+
+	SECTION("max edits = 1"){
+		auto dfa = trimatch::LevenshteinDFA(pattern, integer{1});
+		for(const auto s: text("caf\xc3"))
+			CHECK(dfa.update(s));
+		CHECK(dfa.matched());
+		CHECK(dfa.distance() == 1);
+		CHECK(dfa.update('\xa8'));
+		CHECK(dfa.matched());
+		CHECK(dfa.distance() == 1);
+		dfa.back();
+		CHECK(dfa.update('\xa9'));
+		CHECK(dfa.matched());
+		CHECK(dfa.distance() == 0);
+		CHECK(dfa.update('\xa9'));
+		CHECK(dfa.distance() == 1);
+		CHECK_FALSE(dfa.update('\xff'));
+	}
+}
+
+TEST_CASE("levenshtein_dfa / pattern shorter than max edits", "[DFA][approx]"){
+	for(const text pattern: {"", "A", "AB"}){
+		for(integer max_edits = 0; max_edits <= 3; ++max_edits){
+			auto dfa = trimatch::LevenshteinDFA(pattern, max_edits);
+			CHECK(dfa.matched() == (pattern.size() <= max_edits));
+			if(dfa.matched())
+				CHECK(dfa.distance() == pattern.size());
+		}
+	}
+}
+
+TEST_CASE("levenshtein_dfa / wide symbols", "[DFA][approx]"){
+	std::u32string pattern = U"CORP";
+
+	SECTION("max edits = 1"){
+		auto dfa = trimatch::LevenshteinDFA(pattern, integer{1});
+		for(const auto s: std::u32string(U"CØRP"))
+			CHECK(dfa.update(s));
+		CHECK(dfa.matched());
+		CHECK(dfa.distance() == 1);
+		CHECK_FALSE(dfa.update(U'Ø'));
+	}
+}
+
+TEST_CASE("levenshtein_dfa / reset", "[DFA][approx]"){
+	auto dfa = trimatch::LevenshteinDFA(text("CORP"), integer{1});
+	for(const auto s: text("CO"))
+		CHECK(dfa.update(s));
+
+	SECTION("another pattern"){
+		dfa.reset("CAMP", 2);
+		CHECK(dfa.pattern == "CAMP");
+		CHECK(dfa.max_distance() == 2);
+		for(const auto s: text("CORP"))
+			CHECK(dfa.update(s));
+		CHECK(dfa.matched());
+		CHECK(dfa.distance() == 2);
+
+		dfa.reset("CORP", 0);
+		CHECK_FALSE(dfa.update('K'));
+		for(const auto s: text("CORP"))
+			CHECK(dfa.update(s));
+		CHECK(dfa.matched());
+		CHECK(dfa.distance() == 0);
+	}
+	SECTION("copies keep their automaton"){
+		auto copy = dfa;
+		dfa.reset("XYZ", 0);
+		for(const auto s: text("RE"))
+			CHECK(copy.update(s));
+		CHECK(copy.matched());
+		CHECK(copy.distance() == 1);
+		CHECK_FALSE(dfa.update('C'));
+	}
+	SECTION("compiled automaton"){
+		auto compiled = trimatch::LevenshteinDFA<text, integer>::compile("CAMP", 1);
+		dfa.reset(compiled);
+		for(const auto s: text("CAM"))
+			CHECK(dfa.update(s));
+		CHECK(dfa.matched());
+		dfa.reset("CORP", 1);
+		CHECK(compiled->pattern == "CAMP");
+	}
+}
+
+TEST_CASE("levenshtein_dfa / fixed max edits", "[DFA][approx]"){
+	text pattern = "CORP";
+
+	SECTION("same as dynamic max edits"){
+		trimatch::LevenshteinDFA<text, integer, 2> fixed(pattern, 2);
+		trimatch::LevenshteinDFA<text, integer> dynamic(pattern, 2);
+		CHECK(fixed.max_distance() == 2);
+		for(const text t: {"CORP", "CARP", "CORPUS", "RECORP", "CAMP", "LORD", "RP", "XXRP", "CXXXRP"}){
+			integer depth = 0;
+			for(const auto s: t){
+				bool updated = fixed.update(s);
+				CHECK(updated == dynamic.update(s));
+				if(!updated)
+					break;
+				++depth;
+				CHECK(fixed.matched() == dynamic.matched());
+				CHECK(fixed.distance() == dynamic.distance());
+			}
+			for(; depth > 0; --depth){
+				fixed.back();
+				dynamic.back();
+			}
+		}
+	}
+	SECTION("max edits must match"){
+		CHECK_THROWS_AS((trimatch::LevenshteinDFA<text, integer, 1>(pattern, 2)), std::invalid_argument);
+		trimatch::LevenshteinDFA<text, integer, 1> dfa(pattern, 1);
+		CHECK_THROWS_AS(dfa.reset(pattern, 0), std::invalid_argument);
+	}
+}
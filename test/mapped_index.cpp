@@ -0,0 +1,168 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <iterator>
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#include <Catch2/catch.hpp>
+
+#include <trimatch/index.hpp>
+#include <trimatch/mapped_index.hpp>
+
+
+using text = std::string;
+using integer = std::uint32_t;
+
+
+namespace{
+
+template<class expected_searcher, class actual_searcher>
+void check_same_results(expected_searcher expected, actual_searcher actual)
+{
+	for(const text query: {"", "A", "AM", "AMP", "CAMP", "CAMPING", "CAMPINGS", "MD", "X"}){
+		CHECK(actual.exact(query) == expected.exact(query));
+
+		std::vector<text> expected_predicted, actual_predicted;
+		expected.predict(query, std::back_inserter(expected_predicted));
+		actual.predict(query, std::back_inserter(actual_predicted));
+		CHECK(actual_predicted == expected_predicted);
+
+		std::vector<text> expected_prefixes, actual_prefixes;
+		for(const auto& r: expected.prefix(query))
+			expected_prefixes.push_back(r.key());
+		for(const auto& r: actual.prefix(query))
+			actual_prefixes.push_back(r.key());
+		CHECK(actual_prefixes == expected_prefixes);
+
+		for(integer max_edits = 0; max_edits <= 2; ++max_edits){
+			std::vector<std::tuple<text, typename actual_searcher::value_type, integer>> expected_approx, actual_approx;
+			expected.approx(query, max_edits, std::back_inserter(expected_approx));
+			actual.approx(query, max_edits, std::back_inserter(actual_approx));
+			CHECK(actual_approx == expected_approx);
+
+			std::vector<std::tuple<text, typename actual_searcher::value_type, integer, integer>>
+				expected_predict, actual_predict;
+			expected.approx_predict(query, max_edits, std::back_inserter(expected_predict));
+			actual.approx_predict(query, max_edits, std::back_inserter(actual_predict));
+			CHECK(actual_predict == expected_predict);
+		}
+	}
+}
+
+}
+
+TEST_CASE("mapped_index / set", "[index][mapped]"){
+	std::vector<text> texts = {
+		"",
+		"A",
+		"AM",
+		"AMD",
+		"AMPLIFIER",
+		"CAD",
+		"CAM",
+		"CAMPAIGN",
+		"CAMPING",
+		"CM",
+		"DM",
+		"MD",
+	};
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto path = (std::filesystem::temp_directory_path() / "trimatch_mapped_index_set.bin").string();
+	index.save_mapped(path);
+
+	trimatch::mapped_index<text> mapped(path);
+	CHECK(mapped.raw_trie().node_size() == index.raw_trie().node_size());
+	check_same_results(index.searcher(), mapped.searcher());
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("mapped_index / map", "[index][mapped]"){
+	std::vector<std::pair<text, integer>> texts = {
+		{"A", 1},
+		{"AM", 2},
+		{"AMD", 3},
+		{"AMPLIFIER", 4},
+		{"CAD", 5},
+		{"CAM", 6},
+		{"CAMPAIGN", 7},
+		{"CAMPING", 8},
+		{"CM", 9},
+		{"DM", 10},
+		{"MD", 11},
+	};
+	trimatch::index<text, integer> index(texts);
+	auto path = (std::filesystem::temp_directory_path() / "trimatch_mapped_index_map.bin").string();
+	index.save_mapped(path);
+
+	trimatch::mapped_index<text, integer> mapped(path);
+	check_same_results(index.searcher(), mapped.searcher());
+
+	SECTION("incompatible types"){
+		CHECK_THROWS_AS(trimatch::mapped_index<text>(path), std::runtime_error);
+		CHECK_THROWS_AS((trimatch::mapped_index<text, std::uint64_t>(path)), std::runtime_error);
+	}
+	SECTION("other formats"){
+		auto other = path + ".other";
+		index.save(other);
+		CHECK_THROWS_AS((trimatch::mapped_index<text, integer>(other)), std::runtime_error);
+		std::filesystem::remove(other);
+	}
+	SECTION("replaced while mapped"){
+		std::vector<std::pair<text, integer>> fewer(texts.begin(), texts.begin() + 3);
+		trimatch::index<text, integer> replacement(fewer);
+		replacement.save_mapped(path);
+		check_same_results(index.searcher(), mapped.searcher());
+		trimatch::mapped_index<text, integer> remapped(path);
+		check_same_results(replacement.searcher(), remapped.searcher());
+
+		auto name = std::filesystem::path(path).filename().string();
+		for(const auto& entry: std::filesystem::directory_iterator(std::filesystem::path(path).parent_path()))
+			CHECK(entry.path().filename().string().rfind(name + ".", 0) == std::string::npos);
+	}
+	SECTION("broken node offsets"){
+		std::string bytes;
+		{
+			std::ifstream ifs(path, std::ios::binary);
+			bytes.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+		}
+		// next starts at the first 64-byte boundary after the header of 80 bytes
+		integer broken = 1000;
+		std::memcpy(bytes.data() + 128 + 2 * sizeof(integer), &broken, sizeof(broken));
+		auto other = path + ".broken";
+		{
+			std::ofstream ofs(other, std::ios::binary);
+			ofs.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+		}
+		CHECK_THROWS_AS((trimatch::mapped_index<text, integer>(other)), std::runtime_error);
+		std::filesystem::remove(other);
+	}
+	SECTION("missing file"){
+		std::filesystem::remove(path);
+		CHECK_THROWS_AS((trimatch::mapped_index<text, integer>(path)), std::runtime_error);
+	}
+
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,128 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+
+#include <Catch2/catch.hpp>
+
+#include <trimatch/index.hpp>
+#include <trimatch/partition_search_client.hpp>
+
+
+using text = std::string;
+using integer = std::uint32_t;
+
+
+TEST_CASE("partition_search_client / small dictionary", "[index][approx][partition]"){
+	std::vector<std::pair<text, integer>> texts = {
+		{"A", 1},
+		{"AM", 2},
+		{"AMD", 3},
+		{"AMP", 4},
+		{"AMPLIFIER", 5},
+		{"CAD", 6},
+		{"CAM", 7},
+		{"CAMP", 8},
+		{"CAMPAIGN", 9},
+		{"CAMPING", 10},
+		{"CM", 11},
+		{"DM", 12},
+		{"LIFE", 13},
+		{"MD", 14},
+		{"PAIN", 15},
+	};
+	trimatch::index<text, integer> index(texts);
+	auto searcher = index.searcher();
+	trimatch::reversed_keys<text, decltype(index)::value_type, integer> reversed;
+	reversed.build(index.raw_trie());
+	trimatch::partition_search_client<decltype(index)::trie_type> partitioned(index.raw_trie(), reversed);
+
+	for(integer max_edits = 0; max_edits <= 6; ++max_edits){
+		SECTION("max edits = " + std::to_string(max_edits)){
+			for(const text query: {"", "A", "CAMPAIGN", "AMPLIFIER", "XCAMPX", "PAINLIFE", "MDCM"}){
+				std::vector<std::tuple<text, integer, integer>> expected, actual;
+				searcher.approx(query, max_edits, std::back_inserter(expected));
+				std::sort(expected.begin(), expected.end());
+				partitioned.approx(query, max_edits, std::back_inserter(actual));
+				CHECK(actual == expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("partition_search_client / reversed keys of another trie", "[index][partition]"){
+	trimatch::index<text, integer> index(std::vector<std::pair<text, integer>>{{"CAD", 1}, {"CAM", 2}, {"CAMP", 3}});
+	trimatch::index<text, integer> other(std::vector<std::pair<text, integer>>{{"CAD", 1}, {"CAM", 2}});
+	using trie_type = decltype(index)::trie_type;
+	trimatch::reversed_keys<text, decltype(index)::value_type, integer> reversed;
+
+	SECTION("not built"){
+		CHECK_THROWS_AS(trimatch::partition_search_client<trie_type>(index.raw_trie(), reversed), std::invalid_argument);
+	}
+	SECTION("built from another trie"){
+		reversed.build(other.raw_trie());
+		CHECK_THROWS_AS(trimatch::partition_search_client<trie_type>(index.raw_trie(), reversed), std::invalid_argument);
+	}
+	SECTION("built from the same trie"){
+		reversed.build(index.raw_trie());
+		CHECK_NOTHROW(trimatch::partition_search_client<trie_type>(index.raw_trie(), reversed));
+	}
+}
+
+TEST_CASE("partition_search_client / random dictionary", "[index][approx][partition]"){
+	std::mt19937 engine(23);
+	std::uniform_int_distribution<std::size_t> length(0, 14);
+	std::uniform_int_distribution<int> symbol('a', 'd');
+	auto random_text = [&]{
+		text t(length(engine), 'a');
+		for(auto& c: t)
+			c = static_cast<char>(symbol(engine));
+		return t;
+	};
+
+	std::vector<text> texts;
+	for(int i = 0; i < 2000; ++i)
+		texts.push_back(random_text());
+	sftrie::sort_texts(texts.begin(), texts.end());
+	texts.erase(std::unique(texts.begin(), texts.end()), texts.end());
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto searcher = index.searcher();
+	trimatch::reversed_keys<text, decltype(index)::value_type, integer> reversed;
+	reversed.build(index.raw_trie());
+	trimatch::partition_search_client<decltype(index)::trie_type> partitioned(index.raw_trie(), reversed);
+
+	for(integer max_edits = 0; max_edits <= 6; ++max_edits){
+		SECTION("max edits = " + std::to_string(max_edits)){
+			for(int i = 0; i < 30; ++i){
+				text query = random_text();
+				std::vector<std::tuple<text, bool, integer>> expected, actual;
+				searcher.approx(query, max_edits, std::back_inserter(expected));
+				std::sort(expected.begin(), expected.end());
+				partitioned.approx(query, max_edits, std::back_inserter(actual));
+				CHECK(actual == expected);
+			}
+		}
+	}
+}
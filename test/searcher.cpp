@@ -20,7 +20,10 @@ limitations under the License.
 #include <string>
 #include <vector>
 #include <set>
+#include <algorithm>
 #include <iostream>
+#include <functional>
+#include <stdexcept>
 
 #include <Catch2/catch.hpp>
 
@@ -30,6 +33,62 @@ limitations under the License.
 using text = std::string;
 
 
+// counts matchers constructed from a pattern
+struct counting_matcher: trimatch::LevenshteinDFA<text, std::uint32_t>
+{
+	static inline std::size_t constructed = 0;
+
+	counting_matcher(const text& pattern, std::uint32_t max_edits):
+		trimatch::LevenshteinDFA<text, std::uint32_t>(pattern, max_edits)
+	{
+		++constructed;
+	}
+};
+
+// throws on updates below the given depth
+struct throwing_matcher: trimatch::LevenshteinDFA<text, std::uint32_t>
+{
+	static inline std::size_t max_depth = 3;
+	std::size_t depth = 0;
+
+	throwing_matcher(const text& pattern, std::uint32_t max_edits):
+		trimatch::LevenshteinDFA<text, std::uint32_t>(pattern, max_edits)
+	{}
+
+	bool update(char c)
+	{
+		if(depth >= max_depth)
+			throw std::runtime_error("too deep");
+		bool result = trimatch::LevenshteinDFA<text, std::uint32_t>::update(c);
+		depth += result ? 1 : 0;
+		return result;
+	}
+
+	void back()
+	{
+		trimatch::LevenshteinDFA<text, std::uint32_t>::back();
+		--depth;
+	}
+};
+
+// calls work() on the calling thread as many times as a pool of concurrency() threads would
+struct sequential_executor
+{
+	std::size_t runs = 0;
+
+	std::size_t concurrency() const
+	{
+		return 3;
+	}
+
+	void run(const std::function<void()>& work)
+	{
+		++runs;
+		for(std::size_t i = 0; i < concurrency(); ++i)
+			work();
+	}
+};
+
 TEST_CASE("searcher / small dictionary / exact matching", "[index][exact]"){
 	std::vector<text> texts = {
 		"A",
@@ -229,3 +288,586 @@ TEST_CASE("searcher / small dictionary / approximate search", "[index][approx]")
 		CHECK(results.size() == 1);
 	}
 }
+
+TEST_CASE("searcher / small dictionary / approximate search with automaton cache", "[index][approx][cache]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMP",
+		"CAD",
+		"CA",
+		"CAM",
+		"CAMP",
+		"CM",
+		"CMD",
+		"DM",
+		"MD",
+	};
+	sftrie::sort_texts(texts.begin(), texts.end());
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto searcher = index.searcher();
+	auto cached_searcher = index.searcher();
+	cached_searcher.enable_cache(2);
+
+	SECTION("same results as uncached search"){
+		for(const text query: {"AD", "CORP", "AD", "AM", "AD"}){
+			std::vector<std::tuple<text, unsigned long, unsigned long>> expected, results;
+			searcher.approx(query, 1, std::back_inserter(expected));
+			cached_searcher.approx(query, 1, std::back_inserter(results));
+			CHECK(results == expected);
+
+			std::vector<std::tuple<text, unsigned long, unsigned long>> iterated;
+			for(const auto& [key, value, edits]: cached_searcher.approx(query, 1))
+				iterated.emplace_back(key, value, edits);
+			CHECK(iterated == expected);
+		}
+		CHECK(cached_searcher.cache()->misses() == 3);
+		CHECK(cached_searcher.cache()->hits() == 7);
+		CHECK(cached_searcher.cache()->size() == 2);
+	}
+	SECTION("least recently used automaton is evicted"){
+		std::vector<std::tuple<text, unsigned long, unsigned long>> results;
+		cached_searcher.approx("AD", 1, std::back_inserter(results));
+		cached_searcher.approx("AD", 2, std::back_inserter(results));
+		cached_searcher.approx("AD", 1, std::back_inserter(results));
+		cached_searcher.approx("CM", 1, std::back_inserter(results));
+		CHECK(cached_searcher.cache()->misses() == 3);
+		cached_searcher.approx("AD", 1, std::back_inserter(results));
+		CHECK(cached_searcher.cache()->hits() == 2);
+		cached_searcher.approx("AD", 2, std::back_inserter(results));
+		CHECK(cached_searcher.cache()->misses() == 4);
+	}
+	SECTION("copies share the cache"){
+		auto copied = cached_searcher;
+		std::vector<std::tuple<text, unsigned long, unsigned long>> results;
+		cached_searcher.approx("AD", 1, std::back_inserter(results));
+		std::vector<std::tuple<text, unsigned long, unsigned long, unsigned long>> predicted;
+		copied.approx_predict("AD", 1, std::back_inserter(predicted));
+		CHECK(cached_searcher.cache()->hits() == 1);
+		copied.disable_cache();
+		CHECK_FALSE(copied.cache());
+		CHECK(cached_searcher.cache());
+	}
+}
+
+TEST_CASE("searcher / small dictionary / batched approximate search", "[index][approx][batch]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMP",
+		"CAD",
+		"CA",
+		"CAM",
+		"CAMP",
+		"CM",
+		"CMD",
+		"DM",
+		"MD",
+	};
+	sftrie::sort_texts(texts.begin(), texts.end());
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto searcher = index.searcher();
+
+	SECTION("same results as individual queries"){
+		std::vector<text> queries = {"AD", "CORP", "", "CAMP", "AD", "XYZ"};
+		for(unsigned long max_edits = 0; max_edits <= 2; ++max_edits){
+			std::vector<std::tuple<std::size_t, text, unsigned long, unsigned long>> results;
+			searcher.approx_batch(queries, max_edits, std::back_inserter(results));
+
+			std::vector<std::vector<std::tuple<text, unsigned long, unsigned long>>> grouped(queries.size()), expected(queries.size());
+			for(const auto& [i, key, value, edits]: results)
+				grouped[i].emplace_back(key, value, edits);
+			for(std::size_t i = 0; i < queries.size(); ++i){
+				searcher.approx(queries[i], max_edits, std::back_inserter(expected[i]));
+				CHECK(grouped[i] == expected[i]);
+			}
+		}
+	}
+	SECTION("no queries"){
+		std::vector<std::tuple<std::size_t, text, unsigned long, unsigned long>> results;
+		searcher.approx_batch({}, 1, std::back_inserter(results));
+		CHECK(results.empty());
+	}
+}
+
+TEST_CASE("searcher / small dictionary / reused matcher", "[index][approx]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMP",
+		"CAD",
+		"CA",
+		"CAM",
+		"CAMP",
+		"CM",
+		"CMD",
+		"DM",
+		"MD",
+	};
+	sftrie::sort_texts(texts.begin(), texts.end());
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto searcher = index.searcher();
+	searcher.enable_matcher_reuse();
+	using searcher_type = decltype(searcher);
+
+	SECTION("same results as a new searcher for each query"){
+		std::vector<std::pair<text, unsigned long>> queries = {
+			{"CORP", 2}, {"AD", 1}, {"MD", 0}, {"CAMPS", 3}, {"AD", 1}, {"", 1},
+		};
+		for(const auto& [query, max_edits]: queries){
+			auto fresh = index.searcher();
+
+			std::vector<std::tuple<text, unsigned long, unsigned long>> results, expected;
+			searcher.approx(query, max_edits, std::back_inserter(results));
+			fresh.approx(query, max_edits, std::back_inserter(expected));
+			CHECK(results == expected);
+
+			std::vector<std::tuple<text, unsigned long, unsigned long, unsigned long>> predicted, expected_predicted;
+			searcher.approx_predict(query, max_edits, std::back_inserter(predicted));
+			fresh.approx_predict(query, max_edits, std::back_inserter(expected_predicted));
+			CHECK(predicted == expected_predicted);
+		}
+	}
+	SECTION("nested search from a visitor"){
+		auto fresh = index.searcher();
+		std::vector<std::tuple<text, unsigned long, unsigned long>> results, expected;
+		searcher.approx("CAMP", 1, [&](typename searcher_type::key_view key, typename searcher_type::node_type, std::uint32_t){
+			searcher.approx(text(key), 1, std::back_inserter(results));
+			fresh.approx(text(key), 1, std::back_inserter(expected));
+		});
+		CHECK(!results.empty());
+		CHECK(results == expected);
+	}
+	SECTION("no matcher constructed after warm-up"){
+		trimatch::search_client<decltype(index)::trie_type, counting_matcher> counted(index.raw_trie());
+		std::vector<std::pair<text, std::uint32_t>> queries = {
+			{"CORP", 2}, {"AD", 1}, {"MD", 0}, {"CAMPS", 2}, {"", 1},
+		};
+
+		auto before = counting_matcher::constructed;
+		for(const auto& [query, max_edits]: queries)
+			counted.approx_count(query, max_edits);
+		CHECK(counting_matcher::constructed == before + queries.size());
+
+		counted.enable_matcher_reuse();
+		counted.approx_count("CAMP", 1);
+		before = counting_matcher::constructed;
+		for(const auto& [query, max_edits]: queries){
+			std::vector<std::tuple<text, bool, std::uint32_t, std::uint32_t>> predicted;
+			counted.approx_count(query, max_edits);
+			counted.approx_predict(query, max_edits, std::back_inserter(predicted));
+		}
+		CHECK(counting_matcher::constructed == before);
+	}
+	SECTION("disabled again"){
+		searcher.disable_matcher_reuse();
+		auto fresh = index.searcher();
+		std::vector<std::tuple<text, unsigned long, unsigned long>> results, expected;
+		searcher.approx("CAMPS", 2, std::back_inserter(results));
+		fresh.approx("CAMPS", 2, std::back_inserter(expected));
+		CHECK(results == expected);
+	}
+}
+
+TEST_CASE("searcher / small dictionary / top-k approximate search", "[index][approx][topk]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMP",
+		"CAD",
+		"CA",
+		"CAM",
+		"CAMP",
+		"CM",
+		"CMD",
+		"DM",
+		"MD",
+	};
+	sftrie::sort_texts(texts.begin(), texts.end());
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto searcher = index.searcher();
+
+	SECTION("closest results of approximate search"){
+		for(const text query: {"CAMP", "AD", "MDD", "", "XYZ"}){
+			for(unsigned long max_edits = 0; max_edits <= 3; ++max_edits){
+				std::vector<std::tuple<text, unsigned long, unsigned long>> expected;
+				searcher.approx(query, max_edits, std::back_inserter(expected));
+				std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b){
+					return std::get<2>(a) < std::get<2>(b);
+				});
+
+				for(std::size_t k = 0; k <= expected.size() + 1; ++k){
+					std::vector<std::tuple<text, unsigned long, unsigned long>> results;
+					searcher.approx_topk(query, k, max_edits, std::back_inserter(results));
+					REQUIRE(results.size() == std::min(k, expected.size()));
+					for(std::size_t i = 0; i < results.size(); ++i){
+						CHECK(std::get<2>(results[i]) == std::get<2>(expected[i]));
+						CHECK(std::find(expected.begin(), expected.end(), results[i]) != expected.end());
+					}
+				}
+			}
+		}
+	}
+	SECTION("distances are confirmed in order"){
+		std::vector<std::tuple<text, unsigned long, unsigned long>> results;
+		searcher.approx_topk("CAMP", 3, 2, std::back_inserter(results));
+		REQUIRE(results.size() == 3);
+		CHECK(std::get<0>(results[0]) == "CAMP");
+		CHECK(std::get<2>(results[0]) == 0);
+		CHECK(std::get<2>(results[1]) == 1);
+		CHECK(std::get<2>(results[2]) == 1);
+	}
+}
+
+TEST_CASE("searcher / small dictionary / adaptive approximate search", "[index][approx][adaptive]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMP",
+		"CAD",
+		"CA",
+		"CAM",
+		"CAMP",
+		"CM",
+		"CMD",
+		"DM",
+		"MD",
+	};
+	sftrie::sort_texts(texts.begin(), texts.end());
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto searcher = index.searcher();
+
+	SECTION("all results within the effective radius"){
+		for(const text query: {"CAMP", "AD", "MDD", "", "XYZ"}){
+			for(std::size_t min_results = 0; min_results <= texts.size() + 1; ++min_results){
+				std::vector<std::tuple<text, unsigned long, unsigned long>> results;
+				auto radius = searcher.approx_adaptive(query, min_results, 3, std::back_inserter(results));
+				CHECK(radius <= 3);
+
+				std::vector<std::tuple<text, unsigned long, unsigned long>> expected, smaller;
+				searcher.approx(query, radius, std::back_inserter(expected));
+				CHECK(results.size() == expected.size());
+				for(const auto& r: results)
+					CHECK(std::find(expected.begin(), expected.end(), r) != expected.end());
+				CHECK(std::is_sorted(results.begin(), results.end(), [](const auto& a, const auto& b){
+					return std::get<2>(a) < std::get<2>(b);
+				}));
+
+				// stopped at the first sufficient radius
+				if(radius < 3)
+					CHECK(results.size() >= min_results);
+				if(radius > 0){
+					searcher.approx(query, radius - 1, std::back_inserter(smaller));
+					CHECK(smaller.size() < min_results);
+				}
+			}
+		}
+	}
+	SECTION("exact hit stops at radius 0"){
+		std::vector<std::tuple<text, unsigned long, unsigned long>> results;
+		CHECK(searcher.approx_adaptive("CAMP", 1, 2, std::back_inserter(results)) == 0);
+		REQUIRE(results.size() == 1);
+		CHECK(std::get<0>(results[0]) == "CAMP");
+	}
+	SECTION("escalates until enough results"){
+		std::vector<std::tuple<text, unsigned long, unsigned long>> results;
+		CHECK(searcher.approx_adaptive("CAMP", 2, 2, std::back_inserter(results)) == 1);
+		CHECK(results.size() == 3);
+	}
+}
+
+TEST_CASE("searcher / parallel approximate search", "[index][approx][parallel]"){
+	// enough keys to split below the first level
+	std::vector<text> texts;
+	std::uint32_t x = 12345;
+	for(int i = 0; i < 2000; ++i){
+		text t;
+		x = x * 1103515245 + 12345;
+		for(std::uint32_t length = 1 + (x >> 16) % 6; length > 0; --length){
+			x = x * 1103515245 + 12345;
+			t.push_back(static_cast<char>('A' + (x >> 16) % 4));
+		}
+		texts.push_back(t);
+	}
+	sftrie::sort_texts(texts.begin(), texts.end());
+	texts.erase(std::unique(texts.begin(), texts.end()), texts.end());
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto searcher = index.searcher();
+
+	SECTION("same results in the same order as serial search"){
+		for(const text query: {"ABCD", "DDA", "A", "", "ABCDABCDABCD"}){
+			for(unsigned long max_edits = 0; max_edits <= 3; ++max_edits){
+				std::vector<std::tuple<text, unsigned long, unsigned long>> expected;
+				searcher.approx(query, max_edits, std::back_inserter(expected));
+				for(std::size_t threads: {1, 2, 3, 8}){
+					std::vector<std::tuple<text, unsigned long, unsigned long>> results;
+					searcher.approx_parallel(query, max_edits, threads, std::back_inserter(results));
+					CHECK(results == expected);
+				}
+			}
+		}
+	}
+	SECTION("executor given by the caller"){
+		sequential_executor run;
+		for(const text query: {"ABCD", "DDA", "A", "", "ABCDABCDABCD"}){
+			for(unsigned long max_edits = 0; max_edits <= 3; ++max_edits){
+				std::vector<std::tuple<text, unsigned long, unsigned long>> expected, results;
+				searcher.approx(query, max_edits, std::back_inserter(expected));
+				searcher.approx_parallel(query, max_edits, run, std::back_inserter(results));
+				CHECK(results == expected);
+			}
+		}
+		CHECK(run.runs > 0);
+	}
+	SECTION("exception in a worker"){
+		trimatch::search_client<decltype(index)::trie_type, throwing_matcher> throwing(index.raw_trie());
+		std::vector<std::tuple<text, unsigned long, unsigned long>> results;
+		for(std::size_t threads: {1, 2, 8})
+			CHECK_THROWS_AS(throwing.approx_parallel("ABCD", 1, threads, std::back_inserter(results)), std::runtime_error);
+	}
+}
+
+TEST_CASE("searcher / small dictionary / approximate search with visitor", "[index][approx][visitor]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMP",
+		"CAD",
+		"CA",
+		"CAM",
+		"CAMP",
+		"CM",
+		"CMD",
+		"DM",
+		"MD",
+	};
+	sftrie::sort_texts(texts.begin(), texts.end());
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto searcher = index.searcher();
+	using searcher_type = decltype(searcher);
+
+	SECTION("same results as back inserter"){
+		for(const text query: {"CAMP", "AD", "MDD", "", "XYZ"}){
+			for(unsigned long max_edits = 0; max_edits <= 2; ++max_edits){
+				std::vector<std::tuple<text, unsigned long, unsigned long>> results, expected;
+				searcher.approx(query, max_edits, std::back_inserter(expected));
+				searcher.approx(query, max_edits, [&](typename searcher_type::key_view key, typename searcher_type::node_type node, std::uint32_t edits){
+					results.emplace_back(text(key), node.value(), edits);
+				});
+				CHECK(results == expected);
+			}
+		}
+	}
+	SECTION("aggregate without copying keys"){
+		std::size_t count = 0, exact = 0;
+		searcher.approx("CAMP", 1, [&](typename searcher_type::key_view key, typename searcher_type::node_type, std::uint32_t edits){
+			++count;
+			if(edits == 0)
+				exact += key == "CAMP" ? 1 : 0;
+		});
+		CHECK(count == 3);
+		CHECK(exact == 1);
+	}
+}
+
+TEST_CASE("searcher / small dictionary / approximate search iterator", "[index][approx][iterator]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMP",
+		"CAD",
+		"CA",
+		"CAM",
+		"CAMP",
+		"CM",
+		"CMD",
+		"DM",
+		"MD",
+	};
+	sftrie::sort_texts(texts.begin(), texts.end());
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto searcher = index.searcher();
+	using iterator = decltype(searcher.approx(""));
+	static_assert(std::input_iterator<iterator>);
+	static_assert(std::sentinel_for<std::default_sentinel_t, iterator>);
+	static_assert(std::ranges::input_range<iterator&>);
+
+	SECTION("same results as back inserter"){
+		for(const text query: {"CAMP", "AD", "MDD", "XYZ"}){
+			for(std::uint32_t max_edits = 0; max_edits <= 2; ++max_edits){
+				std::vector<std::tuple<text, unsigned long, unsigned long>> results, expected;
+				searcher.approx(query, max_edits, std::back_inserter(expected));
+				for(const auto& [key, value, edits]: searcher.approx(query, max_edits))
+					results.emplace_back(key, value, edits);
+				CHECK(results == expected);
+			}
+		}
+	}
+	SECTION("query made from a temporary"){
+		std::vector<text> keys;
+		for(auto i = searcher.approx(text("CA") + "MP", 1); i != std::default_sentinel; ++i)
+			keys.emplace_back(i.key());
+		CHECK(keys == std::vector<text>{"AMP", "CAM", "CAMP"});
+	}
+}
+
+TEST_CASE("searcher / small dictionary / search within a budget", "[index][approx][predict][budget]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMP",
+		"CAD",
+		"CA",
+		"CAM",
+		"CAMP",
+		"CM",
+		"CMD",
+		"DM",
+		"MD",
+	};
+	sftrie::sort_texts(texts.begin(), texts.end());
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto searcher = index.searcher();
+
+	SECTION("unlimited budget gives all results"){
+		trimatch::search_budget budget;
+		for(const text query: {"CAMP", "AD", "MDD", "", "C"}){
+			std::vector<text> predicted, expected_predicted;
+			auto status = searcher.predict(query, budget, std::back_inserter(predicted));
+			searcher.predict(query, std::back_inserter(expected_predicted));
+			CHECK_FALSE(status.truncated);
+			CHECK(status.results == predicted.size());
+			CHECK(predicted == expected_predicted);
+
+			for(std::uint32_t max_edits = 0; max_edits <= 2; ++max_edits){
+				std::vector<std::tuple<text, bool, std::uint32_t>> results, expected;
+				status = searcher.approx(query, max_edits, budget, std::back_inserter(results));
+				searcher.approx(query, max_edits, std::back_inserter(expected));
+				CHECK_FALSE(status.truncated);
+				CHECK(results == expected);
+
+				std::vector<std::tuple<text, bool, std::uint32_t, std::uint32_t>> approx_predicted, expected_approx_predicted;
+				status = searcher.approx_predict(query, max_edits, budget, std::back_inserter(approx_predicted));
+				searcher.approx_predict(query, max_edits, std::back_inserter(expected_approx_predicted));
+				CHECK_FALSE(status.truncated);
+				CHECK(approx_predicted == expected_approx_predicted);
+			}
+		}
+	}
+	SECTION("limited results give a prefix of all results"){
+		std::vector<std::tuple<text, bool, std::uint32_t>> expected;
+		searcher.approx("CAMP", 2, std::back_inserter(expected));
+		for(std::size_t k = 0; k <= expected.size(); ++k){
+			trimatch::search_budget budget;
+			budget.max_results = k;
+			std::vector<std::tuple<text, bool, std::uint32_t>> results;
+			auto status = searcher.approx("CAMP", 2, budget, std::back_inserter(results));
+			CHECK(status.truncated == (k < expected.size()));
+			CHECK(results == std::vector<std::tuple<text, bool, std::uint32_t>>(expected.begin(), expected.begin() + k));
+		}
+	}
+	SECTION("limited nodes"){
+		std::vector<text> expected;
+		searcher.predict("", std::back_inserter(expected));
+		trimatch::search_budget budget;
+		budget.max_nodes = 3;
+		std::vector<text> results;
+		auto status = searcher.predict("", budget, std::back_inserter(results));
+		CHECK(status.truncated);
+		CHECK(status.nodes == 3);
+		CHECK(results.size() < expected.size());
+		CHECK(std::equal(results.begin(), results.end(), expected.begin()));
+
+		std::vector<std::tuple<text, bool, std::uint32_t, std::uint32_t>> predicted;
+		status = searcher.approx_predict("A", 2, budget, std::back_inserter(predicted));
+		CHECK(status.truncated);
+		CHECK(status.nodes == 3);
+	}
+	SECTION("expired deadline"){
+		trimatch::search_budget budget;
+		budget.deadline = std::chrono::steady_clock::now();
+		budget.check_interval = 1;
+		std::vector<std::tuple<text, bool, std::uint32_t>> results;
+		auto status = searcher.approx("CAMP", 2, budget, std::back_inserter(results));
+		CHECK(status.truncated);
+		CHECK(status.nodes == 1);
+
+		// 0 does not disable the deadline
+		budget.check_interval = 0;
+		results.clear();
+		status = searcher.approx("CAMP", 2, budget, std::back_inserter(results));
+		CHECK(status.truncated);
+		CHECK(status.nodes == 1);
+	}
+}
+
+TEST_CASE("searcher / small dictionary / ordered approximate predictive search", "[index][approx][predict]"){
+	std::vector<text> texts = {
+		"A",
+		"AM",
+		"AMD",
+		"AMP",
+		"AMPLIFIER",
+		"CA",
+		"CAD",
+		"CAM",
+		"CAMP",
+		"CAMPAIGN",
+		"CAMPING",
+		"CM",
+		"CMD",
+		"DM",
+		"MD",
+	};
+	sftrie::sort_texts(texts.begin(), texts.end());
+
+	auto index = trimatch::build(texts.begin(), texts.end());
+	auto searcher = index.searcher();
+	using result = std::tuple<text, bool, std::uint32_t, std::uint32_t>;
+
+	for(auto order: {trimatch::predict_order::trie, trimatch::predict_order::shortest_first, trimatch::predict_order::fewest_edits_first}){
+		SECTION("order " + std::to_string(static_cast<int>(order))){
+			for(const text query: {"CAMP", "AM", "C", "", "XA", "CAMPIN"}){
+				for(std::uint32_t max_edits = 0; max_edits <= 2; ++max_edits){
+					std::vector<result> all;
+					searcher.approx_predict(query, max_edits, std::back_inserter(all));
+					std::set<text> keys;
+					for(const auto& r: all)
+						keys.insert(std::get<0>(r));
+					CHECK(keys.size() == all.size());
+
+					if(order == trimatch::predict_order::shortest_first)
+						std::stable_sort(all.begin(), all.end(), [](const auto& a, const auto& b){
+							return std::get<0>(a).size() < std::get<0>(b).size();
+						});
+					else if(order == trimatch::predict_order::fewest_edits_first)
+						std::stable_sort(all.begin(), all.end(), [](const auto& a, const auto& b){
+							return std::get<3>(a) < std::get<3>(b);
+						});
+					for(std::size_t k = 0; k <= all.size() + 1; ++k){
+						std::vector<result> results;
+						searcher.approx_predict(query, max_edits, k, order, std::back_inserter(results));
+						CHECK(results == std::vector<result>(all.begin(), all.begin() + std::min(k, all.size())));
+					}
+				}
+			}
+		}
+	}
+}
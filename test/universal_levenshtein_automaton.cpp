@@ -0,0 +1,139 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+
+#include <Catch2/catch.hpp>
+
+#include <trimatch/universal_levenshtein_automaton.hpp>
+
+
+using text = std::string;
+using symbol = typename text::value_type;
+using integer = std::uint32_t;
+
+
+namespace{
+
+bool accepts(const text& pattern, integer max_edits, const text& t, integer& edits)
+{
+	trimatch::UniversalLevenshteinAutomaton<text, integer> automaton(pattern, max_edits);
+	for(const auto s: t)
+		if(!automaton.update(s))
+			return false;
+	edits = automaton.distance();
+	return automaton.matched();
+}
+
+}
+
+
+TEST_CASE("universal_levenshtein_automaton / small pattern", "[UA][approx]"){
+	text pattern = "CORP";
+
+	std::vector<text> texts0 = {
+		"CORP",
+	};
+
+	std::vector<text> texts1 = {
+		"ORP",
+		"COP",
+		"COR",
+		"CCORP",
+		"COORP",
+		"CORPS",
+		"KORP",
+		"CARP",
+		"CORE",
+	};
+
+	std::vector<text> texts2 = {
+		"RP",
+		"CO",
+		"CR",
+		"CORPUS",
+		"RECORP",
+		"COORRP",
+		"CAMP",
+		"LORD",
+		"CARE",
+	};
+
+	std::vector<text> texts3 = {
+		"C",
+		"CORPSES",
+		"CAMPS",
+		"CARES",
+	};
+
+	for(integer max_edits = 0; max_edits <= 3; ++max_edits){
+		SECTION("max edits = " + std::to_string(max_edits)){
+			integer expected = 0;
+			for(const auto& texts: {texts0, texts1, texts2, texts3}){
+				for(const auto& t: texts){
+					integer edits = 0;
+					bool matched = accepts(pattern, max_edits, t, edits);
+					CHECK(matched == (expected <= max_edits));
+					if(matched)
+						CHECK(edits == expected);
+				}
+				++expected;
+			}
+		}
+	}
+}
+
+TEST_CASE("universal_levenshtein_automaton / end of pattern", "[UA][approx]"){
+	SECTION("empty pattern"){
+		integer edits = 0;
+		CHECK(accepts("", 0, "", edits));
+		CHECK(edits == 0);
+		CHECK_FALSE(accepts("", 0, "A", edits));
+		CHECK(accepts("", 2, "AB", edits));
+		CHECK(edits == 2);
+		CHECK_FALSE(accepts("", 2, "ABC", edits));
+	}
+	SECTION("pattern shorter than max edits"){
+		integer edits = 0;
+		CHECK(accepts("A", 3, "", edits));
+		CHECK(edits == 1);
+		CHECK(accepts("A", 3, "BCD", edits));
+		CHECK(edits == 3);
+		CHECK_FALSE(accepts("A", 3, "BCDE", edits));
+	}
+	SECTION("back"){
+		trimatch::UniversalLevenshteinAutomaton<text, integer> automaton("AMD", 1);
+		CHECK(automaton.update('A'));
+		CHECK(automaton.update('M'));
+		CHECK(automaton.matched());
+		CHECK(automaton.distance() == 1);
+		CHECK(automaton.update('P'));
+		CHECK(automaton.matched());
+		CHECK(automaton.distance() == 1);
+		CHECK_FALSE(automaton.update('P'));
+		automaton.back();
+		CHECK(automaton.update('D'));
+		CHECK(automaton.matched());
+		CHECK(automaton.distance() == 0);
+	}
+	SECTION("unsupported max edits"){
+		CHECK_THROWS_AS((trimatch::UniversalLevenshteinAutomaton<text, integer>("CORP", 4)), std::invalid_argument);
+	}
+}
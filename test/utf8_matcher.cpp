@@ -0,0 +1,160 @@
+/*
+trimatch
+https://github.com/tuem/trimatch
+
+Copyright 2021 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+	http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+
+#include <Catch2/catch.hpp>
+
+#include <trimatch/index.hpp>
+#include <trimatch/utf8_matcher.hpp>
+#include <trimatch/bit_parallel_matcher.hpp>
+
+
+using text = std::string;
+using symbol = typename text::value_type;
+using integer = std::uint32_t;
+
+
+namespace{
+
+// edits if t is accepted, max_edits + 1 otherwise
+template<class matcher_type>
+integer edits(matcher_type& matcher, const text& t)
+{
+	integer depth = 0, result = matcher.max_distance() + 1;
+	bool passed = true;
+	for(const auto s: t){
+		if(!matcher.update(s)){
+			passed = false;
+			break;
+		}
+		++depth;
+	}
+	if(passed && matcher.matched())
+		result = matcher.distance();
+	for(; depth > 0; --depth)
+		matcher.back();
+	return result;
+}
+
+}
+
+
+TEST_CASE("utf8_matcher / decode", "[UTF8][approx]"){
+	using matcher_type = trimatch::UTF8Matcher<text, integer>;
+	CHECK(matcher_type::decode("caf\xc3\xa9") == U"café");
+	CHECK(matcher_type::decode("\xe3\x81\x82\xf0\x9f\x98\x80") == U"あ\U0001f600");
+	// stray and truncated bytes are single symbols
+	CHECK(matcher_type::decode("a\x80\xc3").size() == 3);
+}
+
+TEST_CASE("utf8_matcher / edits per code point", "[UTF8][approx]"){
+	SECTION("accented characters"){
+		trimatch::UTF8Matcher<text, integer> matcher("caf\xc3\xa9", 1);
+		CHECK(edits(matcher, "caf\xc3\xa9") == 0);
+		CHECK(edits(matcher, "caf\xc3\xa8") == 1);
+		CHECK(edits(matcher, "cafe") == 1);
+		CHECK(edits(matcher, "caf") == 1);
+		CHECK(edits(matcher, "caf\xc3\xa9s") == 1);
+		CHECK(edits(matcher, "caff\xc3\xa8") == 2);
+		// a truncated code point is a single symbol
+		CHECK(edits(matcher, "caf\xc3") == 1);
+	}
+	SECTION("CJK characters"){
+		// "あいう"
+		trimatch::UTF8Matcher<text, integer> matcher("\xe3\x81\x82\xe3\x81\x84\xe3\x81\x86", 1);
+		CHECK(edits(matcher, "\xe3\x81\x82\xe3\x81\x84\xe3\x81\x86") == 0);
+		CHECK(edits(matcher, "\xe3\x81\x82\xe3\x81\x88\xe3\x81\x86") == 1);
+		CHECK(edits(matcher, "\xe3\x81\x82\xe3\x81\x86") == 1);
+		CHECK(edits(matcher, "\xe3\x81\x82") == 2);
+	}
+	SECTION("broken sequences in keys"){
+		trimatch::UTF8Matcher<text, integer> matcher("caf\xc3\xa9", 2);
+		CHECK(edits(matcher, "caf\xc3" "a") == 2);
+		CHECK(edits(matcher, "caf\xa9") == 1);
+		CHECK(edits(matcher, "caf\xc3\xc3\xa9") == 1);
+	}
+	SECTION("broken sequences match themselves"){
+		for(const text t: {"caf\xc3" "a", "caf\xc3", "\xe3\x81", "\xe3\x81" "a\xe3\x81\x82", "\xa9\xc3", "\xf0\x9f\x98"}){
+			trimatch::UTF8Matcher<text, integer> matcher(t, 1);
+			CHECK(edits(matcher, t) == 0);
+			// the same symbols as the pattern
+			CHECK(edits(matcher, t + "a") == 1);
+			CHECK(edits(matcher, "a" + t) == 1);
+		}
+	}
+	SECTION("other code point matchers"){
+		trimatch::UTF8Matcher<text, integer, trimatch::BitParallelMatcher<std::u32string, integer>> matcher("caf\xc3\xa9", 1);
+		CHECK(edits(matcher, "caf\xc3\xa8") == 1);
+		CHECK(edits(matcher, "cafe") == 1);
+		matcher.reset("\xc3\xa9t\xc3\xa9", 1);
+		CHECK(edits(matcher, "\xc3\xa9t\xc3\xa9") == 0);
+		CHECK(edits(matcher, "et\xc3\xa9") == 1);
+	}
+}
+
+TEST_CASE("utf8_matcher / approximate search on index", "[index][approx][UTF8]"){
+	using matcher_type = trimatch::UTF8Matcher<text, integer>;
+
+	// "cafe", "café", "cafès", "cave", "été", "あいう", "あう"
+	std::vector<text> texts = {
+		"cafe",
+		"caf\xc3\xa9",
+		"caf\xc3\xa8s",
+		"cave",
+		"\xc3\xa9t\xc3\xa9",
+		"\xe3\x81\x82\xe3\x81\x84\xe3\x81\x86",
+		"\xe3\x81\x82\xe3\x81\x86",
+	};
+	sftrie::sort_texts(texts.begin(), texts.end());
+	std::vector<std::u32string> texts32;
+	for(const auto& t: texts)
+		texts32.push_back(matcher_type::decode(t));
+	sftrie::sort_texts(texts32.begin(), texts32.end());
+
+	using trie_type = typename trimatch::trie_selector<sftrie::empty>::template trie_type<text, integer>;
+	using index_type = trimatch::index<text, sftrie::empty, integer, trie_type, matcher_type>;
+	index_type index(texts);
+	auto searcher = index.searcher();
+	auto index32 = trimatch::build(texts32);
+	auto searcher32 = index32.searcher();
+
+	SECTION("same results as code point index"){
+		for(const text query: {"caf\xc3\xa9", "cafe", "\xc3\xa9t\xc3\xa9", "\xe3\x81\x82\xe3\x81\x84", "x"}){
+			for(integer max_edits = 0; max_edits <= 2; ++max_edits){
+				std::vector<std::tuple<text, unsigned long, unsigned long>> results;
+				searcher.approx(query, max_edits, std::back_inserter(results));
+				std::vector<std::tuple<std::u32string, unsigned long, unsigned long>> expected;
+				searcher32.approx(matcher_type::decode(query), max_edits, std::back_inserter(expected));
+
+				std::vector<std::pair<std::u32string, unsigned long>> decoded, decoded_expected;
+				for(const auto& [key, value, edits]: results)
+					decoded.emplace_back(matcher_type::decode(key), edits);
+				for(const auto& [key, value, edits]: expected)
+					decoded_expected.emplace_back(key, edits);
+				std::sort(decoded.begin(), decoded.end());
+				std::sort(decoded_expected.begin(), decoded_expected.end());
+				CHECK(decoded == decoded_expected);
+			}
+		}
+	}
+}